@@ -0,0 +1,296 @@
+#ifndef MYTINYSTL_AHO_CORASICK_H_
+#define MYTINYSTL_AHO_CORASICK_H_
+
+// 这个头文件包含一个模版类 aho_corasick
+// aho_corasick : 多模式匹配自动机，一次编译后可以在任意多的区间中同时查找所有模式
+
+// notes:
+//
+// 编译时先把模式中出现过的符号压缩为连续的符号类(0 表示不在任何模式中出现)，
+// 再构造完整的确定性自动机：状态转移表为 状态数 x 符号类数 的稠密数组，
+// 匹配时每个符号只需一次查表，不需要沿失败链回退。
+// 单字节整数符号用 256 项数组映射符号类，其余类型在有序字母表中二分查找。
+//
+// 匹配到模式时调用回调函数 f(pattern_id, end)，end 为匹配结束位置(不含)
+// 相对于输入起点的偏移，匹配区间为 [end - pattern_length(pattern_id), end)。
+// matcher 保存匹配状态，可以分块多次调用 feed，跨越块边界的匹配也能找到。
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "algo.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "type_traits.h"
+#include "vector.h"
+
+namespace mystl {
+
+template <class T> class aho_corasick {
+public:
+  typedef T symbol_type;
+  typedef uint32_t state_type;
+
+  class matcher;
+
+private:
+  // 单字节整数使用数组映射符号类
+  typedef m_bool_constant<std::is_integral<T>::value && sizeof(T) == 1>
+      byte_symbol;
+
+  static constexpr state_type kNoState = static_cast<state_type>(-1);
+  static constexpr state_type kRoot = 0;
+
+  mystl::vector<T> symbols_;     // 所有模式依次存放
+  mystl::vector<size_t> bounds_; // 模式 i 占 [bounds_[i], bounds_[i + 1])
+  bool compiled_;
+
+  size_t classes_;               // 符号类数，包括 0 号类
+  uint16_t byte_class_[256];     // 单字节符号的符号类
+  mystl::vector<T> alphabet_;    // 其他类型的有序字母表，下标加一为符号类
+
+  mystl::vector<state_type> delta_;     // 状态转移表
+  mystl::vector<state_type> dict_;      // 沿失败链最近的有输出的状态
+  mystl::vector<uint32_t> out_bounds_;  // 状态 s 的输出为 out_ids_ 的一段
+  mystl::vector<uint32_t> out_ids_;     // 各状态自身的输出(模式编号)
+  mystl::vector<unsigned char> report_; // 状态自身或其输出链上是否有输出
+
+public:
+  aho_corasick() : compiled_(false), classes_(1) { bounds_.emplace_back(0); }
+
+  // 加入一个模式，返回其编号。加入模式后需要重新调用 compile
+  template <class InputIter>
+  size_t add_pattern(InputIter first, InputIter last) {
+    THROW_LENGTH_ERROR_IF(first == last,
+                          "aho_corasick<T>'s pattern can not be empty");
+    for (; first != last; ++first) {
+      symbols_.emplace_back(*first);
+    }
+    bounds_.emplace_back(symbols_.size());
+    compiled_ = false;
+    return bounds_.size() - 2;
+  }
+
+  // 根据已加入的模式构造自动机
+  void compile();
+
+  bool compiled() const noexcept { return compiled_; }
+  size_t pattern_count() const noexcept { return bounds_.size() - 1; }
+  size_t pattern_length(size_t id) const {
+    MYSTL_DEBUG(id < pattern_count());
+    return bounds_[id + 1] - bounds_[id];
+  }
+  size_t state_count() const noexcept { return dict_.size(); }
+
+  // 返回一个从初始状态开始的 matcher
+  matcher make_matcher() const { return matcher(*this); }
+
+  // 在 [first, last) 中查找所有模式，返回匹配的次数
+  template <class InputIter, class Callback>
+  size_t match(InputIter first, InputIter last, Callback f) const {
+    matcher m(*this);
+    return m.feed(first, last, f);
+  }
+
+private:
+  size_t symbol_class(const T &c, m_true_type) const {
+    return byte_class_[static_cast<unsigned char>(c)];
+  }
+
+  size_t symbol_class(const T &c, m_false_type) const {
+    auto it = mystl::lower_bound(alphabet_.begin(), alphabet_.end(), c);
+    return it != alphabet_.end() && !(c < *it)
+               ? static_cast<size_t>(it - alphabet_.begin()) + 1
+               : 0;
+  }
+
+  state_type next(state_type s, const T &c) const {
+    return delta_[s * classes_ + symbol_class(c, byte_symbol())];
+  }
+
+  template <class Callback>
+  size_t report(state_type s, size_t end, Callback &f) const {
+    size_t n = 0;
+    for (; s != kNoState; s = dict_[s]) {
+      for (uint32_t k = out_bounds_[s]; k != out_bounds_[s + 1]; ++k) {
+        f(static_cast<size_t>(out_ids_[k]), end);
+        ++n;
+      }
+    }
+    return n;
+  }
+
+  void build_classes(m_true_type);
+  void build_classes(m_false_type);
+  state_type new_state();
+};
+
+/*****************************************************************************************/
+// matcher
+// 保存匹配时的当前状态与已处理的符号数
+/*****************************************************************************************/
+template <class T> class aho_corasick<T>::matcher {
+public:
+  explicit matcher(const aho_corasick &ac) noexcept
+      : ac_(&ac), state_(kRoot), offset_(0) {
+    MYSTL_DEBUG(ac.compiled());
+  }
+
+  // 继续处理 [first, last)，返回本次找到的匹配次数
+  template <class InputIter, class Callback>
+  size_t feed(InputIter first, InputIter last, Callback f) {
+    size_t n = 0;
+    state_type s = state_;
+    size_t pos = offset_;
+    for (; first != last; ++first) {
+      s = ac_->next(s, *first);
+      ++pos;
+      if (ac_->report_[s]) {
+        n += ac_->report(s, pos, f);
+      }
+    }
+    state_ = s;
+    offset_ = pos;
+    return n;
+  }
+
+  // 回到初始状态，偏移重新从 0 开始
+  void reset() noexcept {
+    state_ = kRoot;
+    offset_ = 0;
+  }
+
+  size_t offset() const noexcept { return offset_; }
+
+private:
+  const aho_corasick *ac_;
+  state_type state_;
+  size_t offset_;
+};
+
+/*****************************************************************************************/
+// helper function
+
+template <class T> void aho_corasick<T>::build_classes(m_true_type) {
+  for (size_t i = 0; i < 256; ++i) {
+    byte_class_[i] = 0;
+  }
+  for (size_t i = 0; i < symbols_.size(); ++i) {
+    byte_class_[static_cast<unsigned char>(symbols_[i])] = 1;
+  }
+  classes_ = 1;
+  for (size_t i = 0; i < 256; ++i) {
+    if (byte_class_[i] != 0) {
+      byte_class_[i] = static_cast<uint16_t>(classes_++);
+    }
+  }
+}
+
+template <class T> void aho_corasick<T>::build_classes(m_false_type) {
+  mystl::vector<T> sorted(symbols_.begin(), symbols_.end());
+  mystl::sort(sorted.begin(), sorted.end());
+  alphabet_.clear();
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    if (i == 0 || alphabet_.back() < sorted[i]) {
+      alphabet_.emplace_back(sorted[i]);
+    }
+  }
+  classes_ = alphabet_.size() + 1;
+}
+
+// 新建一个没有任何转移的状态
+template <class T>
+typename aho_corasick<T>::state_type aho_corasick<T>::new_state() {
+  const auto s = static_cast<state_type>(dict_.size());
+  for (size_t c = 0; c < classes_; ++c) {
+    delta_.emplace_back(kNoState);
+  }
+  dict_.emplace_back(kNoState);
+  return s;
+}
+
+template <class T> void aho_corasick<T>::compile() {
+  build_classes(byte_symbol());
+  delta_.clear();
+  dict_.clear();
+  new_state();
+
+  // 构造字典树，记录每个模式结束的状态
+  const size_t npattern = pattern_count();
+  mystl::vector<state_type> terminal;
+  terminal.reserve(npattern);
+  for (size_t p = 0; p < npattern; ++p) {
+    state_type s = kRoot;
+    for (size_t i = bounds_[p]; i != bounds_[p + 1]; ++i) {
+      const size_t c = symbol_class(symbols_[i], byte_symbol());
+      if (delta_[s * classes_ + c] == kNoState) {
+        const state_type t = new_state();
+        delta_[s * classes_ + c] = t;
+      }
+      s = delta_[s * classes_ + c];
+    }
+    terminal.emplace_back(s);
+  }
+  const size_t nstate = dict_.size();
+
+  // 各状态自身的输出按状态编号排列
+  out_bounds_.clear();
+  out_ids_.clear();
+  for (size_t s = 0; s <= nstate; ++s) {
+    out_bounds_.emplace_back(0);
+  }
+  for (size_t p = 0; p < npattern; ++p) {
+    ++out_bounds_[terminal[p] + 1];
+  }
+  for (size_t s = 0; s < nstate; ++s) {
+    out_bounds_[s + 1] += out_bounds_[s];
+  }
+  mystl::vector<uint32_t> cursor(out_bounds_.begin(), out_bounds_.end());
+  for (size_t p = 0; p < npattern; ++p) {
+    out_ids_.emplace_back(0);
+  }
+  for (size_t p = 0; p < npattern; ++p) {
+    out_ids_[cursor[terminal[p]]++] = static_cast<uint32_t>(p);
+  }
+
+  // 按广度优先的顺序求失败状态，并把缺失的转移补全为确定性自动机
+  mystl::vector<state_type> fail;
+  mystl::vector<state_type> order;
+  fail.reserve(nstate);
+  order.reserve(nstate);
+  for (size_t s = 0; s < nstate; ++s) {
+    fail.emplace_back(kRoot);
+  }
+  order.emplace_back(kRoot);
+  for (size_t i = 0; i < order.size(); ++i) {
+    const state_type s = order[i];
+    for (size_t c = 0; c < classes_; ++c) {
+      state_type &u = delta_[s * classes_ + c];
+      const state_type via_fail =
+          s == kRoot ? kRoot : delta_[fail[s] * classes_ + c];
+      if (u == kNoState) {
+        u = via_fail;
+      } else {
+        fail[u] = via_fail;
+        order.emplace_back(u);
+      }
+    }
+  }
+
+  // 输出链接指向沿失败链最近的有输出的状态
+  report_.clear();
+  for (size_t s = 0; s < nstate; ++s) {
+    report_.emplace_back(0);
+  }
+  for (size_t i = 1; i < order.size(); ++i) {
+    const state_type u = order[i];
+    const state_type f = fail[u];
+    dict_[u] = out_bounds_[f] != out_bounds_[f + 1] ? f : dict_[f];
+    report_[u] = out_bounds_[u] != out_bounds_[u + 1] || dict_[u] != kNoState;
+  }
+  compiled_ = true;
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_AHO_CORASICK_H_
@@ -4,15 +4,18 @@
 // 这个头文件包含了mystl的一系列算法
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
-#include <ctime>
+#include <cstdint>
 
 #include "algobase.h"
 #include "functional.h"
 #include "heap_algo.h"
 #include "iterator.h"
 #include "memory.h"
+#include "random.h"
 #include "util.h"
+#include "vector.h"
 
 namespace mystl {
 /********************************************************************************/
@@ -62,7 +65,8 @@ bool none_of(InputIter first, InputIter last, UnaryPredicate unary_pred) {
 // last)区间内的元素与给定值进行比较，缺省使用operator==，返回元素相等的个数
 /*****************************************************************************************/
 template <class InputIter, class T>
-size_t count(InputIter first, InputIter last, const T &value) {
+size_t count_dispatch(InputIter first, InputIter last, const T &value,
+                      m_false_type) {
   size_t n = 0;
   for (; first != last; ++first) {
     if (*first == value) {
@@ -71,12 +75,48 @@ size_t count(InputIter first, InputIter last, const T &value) {
   }
   return n;
 }
+
+// 分段迭代器逐段计数，段内可使用指针的向量化版本
+template <class SegIter, class T>
+size_t count_dispatch(SegIter first, SegIter last, const T &value,
+                      m_true_type);
+
+template <class InputIter, class T>
+size_t count(InputIter first, InputIter last, const T &value) {
+  return mystl::count_dispatch(first, last, value,
+                               is_segmented_iterator<InputIter>());
+}
+// 为算术类型的指针提供向量化版本
+template <class Tp, class Up>
+typename std::enable_if<
+    is_simd_find_value<typename std::remove_const<Tp>::type, Up>::value,
+    size_t>::type
+count(Tp *first, Tp *last, const Up &value) {
+  typedef typename std::remove_const<Tp>::type T;
+  if (!mystl::simd_find_value_fits<T>(value)) {
+    return 0;
+  }
+  const T v = static_cast<T>(value);
+  return mystl::simd_count<T>(first, last, v);
+}
+
+template <class SegIter, class T>
+size_t count_dispatch(SegIter first, SegIter last, const T &value,
+                      m_true_type) {
+  size_t n = 0;
+  mystl::for_each_segment(first, last, [&](auto, auto f, auto l) {
+    n += mystl::count(f, l, value);
+    return false;
+  });
+  return n;
+}
 /*****************************************************************************************/
 // count_if对[first, last)区间内的每个元素都进行一元 unary_pred
 // 操作，返回结果为true的个数
 /*****************************************************************************************/
 template <class InputIter, class UnaryPredicate>
-size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred) {
+size_t count_if_dispatch(InputIter first, InputIter last,
+                         UnaryPredicate &unary_pred, m_false_type) {
   size_t n = 0;
   for (; first != last; ++first) {
     if (unary_pred(*first)) {
@@ -85,12 +125,30 @@ size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred) {
   }
   return n;
 }
+
+template <class SegIter, class UnaryPredicate>
+size_t count_if_dispatch(SegIter first, SegIter last,
+                         UnaryPredicate &unary_pred, m_true_type) {
+  size_t n = 0;
+  mystl::for_each_segment(first, last, [&](auto, auto f, auto l) {
+    n += mystl::count_if_dispatch(f, l, unary_pred, m_false_type());
+    return false;
+  });
+  return n;
+}
+
+template <class InputIter, class UnaryPredicate>
+size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred) {
+  return mystl::count_if_dispatch(first, last, unary_pred,
+                                  is_segmented_iterator<InputIter>());
+}
 /*****************************************************************************************/
 // find
 // 在[first, last)区间内找到等于 value 的元素，返回指向该元素的迭代器
 /*****************************************************************************************/
 template <class InputIter, class T>
-InputIter find(InputIter first, InputIter last, const T &value) {
+InputIter find_dispatch(InputIter first, InputIter last, const T &value,
+                        m_false_type) {
   for (; first != last; ++first) {
     if (*first == value) {
       return first;
@@ -98,13 +156,55 @@ InputIter find(InputIter first, InputIter last, const T &value) {
   }
   return last;
 }
+
+// 分段迭代器逐段查找，段内可使用指针的向量化版本
+template <class SegIter, class T>
+SegIter find_dispatch(SegIter first, SegIter last, const T &value,
+                      m_true_type);
+
+template <class InputIter, class T>
+InputIter find(InputIter first, InputIter last, const T &value) {
+  return mystl::find_dispatch(first, last, value,
+                              is_segmented_iterator<InputIter>());
+}
+
+// 为算术类型的指针提供向量化版本，单字节类型使用 memchr
+template <class Tp, class Up>
+typename std::enable_if<
+    is_simd_find_value<typename std::remove_const<Tp>::type, Up>::value,
+    Tp *>::type
+find(Tp *first, Tp *last, const Up &value) {
+  typedef typename std::remove_const<Tp>::type T;
+  if (!mystl::simd_find_value_fits<T>(value)) {
+    return last;
+  }
+  const T v = static_cast<T>(value);
+  return first + (mystl::simd_find<T>(first, last, v) - first);
+}
+
+template <class SegIter, class T>
+SegIter find_dispatch(SegIter first, SegIter last, const T &value,
+                      m_true_type) {
+  typedef segmented_iterator_traits<SegIter> traits;
+  SegIter result = last;
+  mystl::for_each_segment(first, last, [&](auto seg, auto f, auto l) {
+    const auto it = mystl::find(f, l, value);
+    if (it == l) {
+      return false;
+    }
+    result = traits::compose(seg, it);
+    return true;
+  });
+  return result;
+}
 /*****************************************************************************************/
 // find_if
 // 在[first, last)区间内找到第一个令一元操作 unary_pred 为 true
 // 的元素并返回指向该元素的迭代器
 /*****************************************************************************************/
 template <class InputIter, class UnaryPredicate>
-InputIter find_if(InputIter first, InputIter last, UnaryPredicate unary_pred) {
+InputIter find_if_dispatch(InputIter first, InputIter last,
+                           UnaryPredicate &unary_pred, m_false_type) {
   for (; first != last; ++first) {
     if (unary_pred(*first)) {
       return first;
@@ -112,6 +212,29 @@ InputIter find_if(InputIter first, InputIter last, UnaryPredicate unary_pred) {
   }
   return last;
 }
+
+template <class SegIter, class UnaryPredicate>
+SegIter find_if_dispatch(SegIter first, SegIter last,
+                         UnaryPredicate &unary_pred, m_true_type) {
+  typedef segmented_iterator_traits<SegIter> traits;
+  SegIter result = last;
+  mystl::for_each_segment(first, last, [&](auto seg, auto f, auto l) {
+    const auto it =
+        mystl::find_if_dispatch(f, l, unary_pred, m_false_type());
+    if (it == l) {
+      return false;
+    }
+    result = traits::compose(seg, it);
+    return true;
+  });
+  return result;
+}
+
+template <class InputIter, class UnaryPredicate>
+InputIter find_if(InputIter first, InputIter last, UnaryPredicate unary_pred) {
+  return mystl::find_if_dispatch(first, last, unary_pred,
+                                 is_segmented_iterator<InputIter>());
+}
 /*****************************************************************************************/
 // find_if_not
 // 在[first, last)区间内找到第一个令一元操作 unary_pred 为 false
@@ -130,10 +253,20 @@ InputIter find_if_not(InputIter first, InputIter last,
 /*****************************************************************************************/
 // search
 // 在[first1, last1)中查找[first2, last2)的首次出现点
-/*****************************************************************************************/
+// 元素为整数的随机访问区间按模式长度选择算法：短模式逐个位置比较，
+// 单字节指针区间使用向量化的首尾字节筛选，其余使用线性时间的 Two-Way 算法
+// 其他情况逐个位置比较。可以用 searcher.h 中的查找器显式指定算法
+/*****************************************************************************************/
+// 小于该长度的模式逐个位置比较
+constexpr static size_t kSearchShortPattern = 8;
+// 单字节区间中不超过该长度的模式使用向量化筛选
+constexpr static size_t kSearchFilterMaxPattern = 64;
+
+// 一般版本：逐个位置比较，失配时从下一个位置重新开始
 template <class ForwardIter1, class ForwardIter2>
-ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
-                    ForwardIter2 first2, ForwardIter2 last2) {
+ForwardIter1 search_aux(ForwardIter1 first1, ForwardIter1 last1,
+                        ForwardIter2 first2, ForwardIter2 last2,
+                        m_false_type) {
   auto d1 = mystl::distance(first1, last1);
   auto d2 = mystl::distance(first2, last2);
   if (d1 < d2)
@@ -156,6 +289,190 @@ ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
   }
   return first1;
 }
+
+// 在 comp 给出的序下求模式 [x, x + m) 的最大后缀，返回后缀起点的前一个位置，
+// period 为该后缀的周期。reverse 为 true 时使用相反的序
+template <class RandomIter, class Distance, class Compared>
+Distance two_way_max_suffix(RandomIter x, Distance m, Distance &period,
+                            bool reverse, Compared comp) {
+  Distance ms = -1, j = 0, k = 1;
+  period = 1;
+  while (j + k < m) {
+    const auto &a = x[j + k];
+    const auto &b = x[ms + k];
+    if (reverse ? comp(b, a) : comp(a, b)) {
+      j += k;
+      k = 1;
+      period = j - ms;
+    } else if (!comp(a, b) && !comp(b, a)) {
+      if (k != period) {
+        ++k;
+      } else {
+        j += period;
+        k = 1;
+      }
+    } else {
+      ms = j;
+      j = ms + 1;
+      k = period = 1;
+    }
+  }
+  return ms;
+}
+
+// 求模式 [x, x + m) 的临界分解 x[0, ell] x[ell + 1, m)，per 为使用的周期，
+// 返回模式是否以 per 为周期
+template <class RandomIter, class Distance, class Compared>
+bool two_way_factorize(RandomIter x, Distance m, Distance &ell, Distance &per,
+                       Compared comp) {
+  Distance p, q;
+  const Distance i1 = mystl::two_way_max_suffix(x, m, p, false, comp);
+  const Distance i2 = mystl::two_way_max_suffix(x, m, q, true, comp);
+  ell = i1 > i2 ? i1 : i2;
+  per = i1 > i2 ? p : q;
+  for (Distance i = 0; i <= ell; ++i) {
+    if (comp(x[i], x[i + per]) || comp(x[i + per], x[i])) {
+      per = (ell + 1 > m - ell - 1 ? ell + 1 : m - ell - 1) + 1;
+      return false;
+    }
+  }
+  return true;
+}
+
+// 使用已经求出的临界分解在 [first1, last1) 中查找长度为 m(m > 0) 的模式
+template <class RandomIter1, class RandomIter2, class Distance,
+          class Compared>
+RandomIter1 two_way_search_aux(RandomIter1 first1, RandomIter1 last1,
+                               RandomIter2 first2, Distance m, Distance ell,
+                               Distance per, bool periodic, Compared comp) {
+  const Distance n = last1 - first1;
+  auto eq = [&comp](const auto &a, const auto &b) {
+    return !comp(a, b) && !comp(b, a);
+  };
+  Distance j = 0;
+  if (periodic) {
+    // 模式是周期的，记住已经匹配的前缀以保证线性时间
+    Distance memory = -1;
+    while (j <= n - m) {
+      Distance i = (ell > memory ? ell : memory) + 1;
+      while (i < m && eq(first2[i], first1[i + j])) {
+        ++i;
+      }
+      if (i >= m) {
+        i = ell;
+        while (i > memory && eq(first2[i], first1[i + j])) {
+          --i;
+        }
+        if (i <= memory) {
+          return first1 + j;
+        }
+        j += per;
+        memory = m - per - 1;
+      } else {
+        j += i - ell;
+        memory = -1;
+      }
+    }
+  } else {
+    while (j <= n - m) {
+      Distance i = ell + 1;
+      while (i < m && eq(first2[i], first1[i + j])) {
+        ++i;
+      }
+      if (i >= m) {
+        i = ell;
+        while (i >= 0 && eq(first2[i], first1[i + j])) {
+          --i;
+        }
+        if (i < 0) {
+          return first1 + j;
+        }
+        j += per;
+      } else {
+        j += i - ell;
+      }
+    }
+  }
+  return last1;
+}
+
+// two_way_search
+// Crochemore-Perrin Two-Way 算法，最坏 O(n + m) 次比较，只需常数额外空间
+// comp 为元素间的严格弱序，两个元素互不小于对方时视为相等
+template <class RandomIter1, class RandomIter2, class Compared>
+RandomIter1 two_way_search(RandomIter1 first1, RandomIter1 last1,
+                           RandomIter2 first2, RandomIter2 last2,
+                           Compared comp) {
+  typedef typename iterator_traits<RandomIter2>::difference_type Distance;
+  const Distance m = last2 - first2;
+  if (m == 0) {
+    return first1;
+  }
+  if (last1 - first1 < m) {
+    return last1;
+  }
+  Distance ell, per;
+  const bool periodic = mystl::two_way_factorize(first2, m, ell, per, comp);
+  return mystl::two_way_search_aux(first1, last1, first2, m, ell, per,
+                                   periodic, comp);
+}
+
+// search_engine: 按模式长度在整数区间上选择查找算法，要求 2 <= m <= n
+template <class RandomIter1, class RandomIter2>
+RandomIter1 search_engine(RandomIter1 first1, RandomIter1 last1,
+                          RandomIter2 first2, RandomIter2 last2) {
+  typedef typename iterator_traits<RandomIter2>::value_type T;
+  if (static_cast<size_t>(last2 - first2) < kSearchShortPattern) {
+    return mystl::search_aux(first1, last1, first2, last2, m_false_type());
+  }
+  return mystl::two_way_search(first1, last1, first2, last2, mystl::less<T>());
+}
+
+// 单字节类型的指针提供特化版本
+template <class Tp, class Up>
+typename std::enable_if<
+    sizeof(Tp) == 1 &&
+        std::is_same<typename std::remove_const<Tp>::type,
+                     typename std::remove_const<Up>::type>::value,
+    Tp *>::type
+search_engine(Tp *first1, Tp *last1, Up *first2, Up *last2) {
+  typedef typename std::remove_const<Tp>::type T;
+  const auto m = static_cast<size_t>(last2 - first2);
+  if (m <= kSearchFilterMaxPattern) {
+    return first1 + (mystl::simd_search<T>(first1, last1, first2, m) - first1);
+  }
+  return mystl::two_way_search(first1, last1, first2, last2, mystl::less<T>());
+}
+
+// 元素为整数的随机访问区间
+template <class RandomIter1, class RandomIter2>
+RandomIter1 search_aux(RandomIter1 first1, RandomIter1 last1,
+                       RandomIter2 first2, RandomIter2 last2, m_true_type) {
+  const auto m = last2 - first2;
+  if (m == 0) {
+    return first1;
+  }
+  if (last1 - first1 < m) {
+    return last1;
+  }
+  if (m == 1) {
+    return mystl::find(first1, last1, *first2);
+  }
+  return mystl::search_engine(first1, last1, first2, last2);
+}
+
+template <class ForwardIter1, class ForwardIter2>
+ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
+                    ForwardIter2 first2, ForwardIter2 last2) {
+  typedef typename iterator_traits<ForwardIter1>::value_type T1;
+  typedef typename iterator_traits<ForwardIter2>::value_type T2;
+  return mystl::search_aux(
+      first1, last1, first2, last2,
+      m_bool_constant<is_random_access_iterator<ForwardIter1>::value &&
+                      is_random_access_iterator<ForwardIter2>::value &&
+                      std::is_integral<T1>::value &&
+                      std::is_same<T1, T2>::value>());
+}
 // 重载版本使用函数对象 comp 代替比较操作
 template <class ForwardIter1, class ForwardIter2, class Compared>
 ForwardIter1 search(ForwardIter1 first1, ForwardIter1 last1,
@@ -385,10 +702,26 @@ InputIter find_first_of(InputIter first1, InputIter last1, ForwardIter first2,
 // 操作，但不能改变元素内容 f() 可返回一个值，但该值会被忽略
 /*****************************************************************************************/
 template <class InputIter, class Function>
-Function for_each(InputIter first, InputIter last, Function f) {
+void for_each_dispatch(InputIter first, InputIter last, Function &f,
+                       m_false_type) {
   for (; first != last; ++first) {
     f(*first);
   }
+}
+
+template <class SegIter, class Function>
+void for_each_dispatch(SegIter first, SegIter last, Function &f,
+                       m_true_type) {
+  mystl::for_each_segment(first, last, [&f](auto, auto lf, auto ll) {
+    mystl::for_each_dispatch(lf, ll, f, m_false_type());
+    return false;
+  });
+}
+
+template <class InputIter, class Function>
+Function for_each(InputIter first, InputIter last, Function f) {
+  mystl::for_each_dispatch(first, last, f,
+                           is_segmented_iterator<InputIter>());
   return f;
 }
 
@@ -448,23 +781,23 @@ ForwardIter lbound_dispatch(ForwardIter first, ForwardIter last, const T &value,
   return first;
 }
 // lbound_dispatch 的 random_access_iterator_tag 版本
+// 无分支的二分查找：每步只根据比较结果选择新的起点，可以编译为条件传送，
+// 同时预取下一步两个可能的中点
 template <class RandomIter, class T>
 RandomIter lbound_dispatch(RandomIter first, RandomIter last, const T &value,
                            random_access_iterator_tag) {
   auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0) {
-    half = len >> 1;
-    middle = first + half;
-    if (*middle < value) {
-      first = middle + 1;
-      len = len - half - 1;
-    } else {
-      len = half;
-    }
+  if (len == 0) {
+    return first;
   }
-  return first;
+  while (len > 1) {
+    const auto half = len / 2;
+    len -= half;
+    mystl::simd_prefetch(first + len / 2);
+    mystl::simd_prefetch(first + half + len / 2);
+    first = *(first + half) < value ? first + half : first;
+  }
+  return *first < value ? first + 1 : first;
 }
 template <class ForwardIter, class T>
 ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value) {
@@ -497,19 +830,17 @@ template <class RandomIter, class T, class Compared>
 RandomIter lbound_dispatch(RandomIter first, RandomIter last, const T &value,
                            random_access_iterator_tag, Compared comp) {
   auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0) {
-    half = len >> 1;
-    middle = first + half;
-    if (comp(*middle, value)) {
-      first = middle + 1;
-      len = len - half - 1;
-    } else {
-      len = half;
-    }
+  if (len == 0) {
+    return first;
   }
-  return first;
+  while (len > 1) {
+    const auto half = len / 2;
+    len -= half;
+    mystl::simd_prefetch(first + len / 2);
+    mystl::simd_prefetch(first + half + len / 2);
+    first = comp(*(first + half), value) ? first + half : first;
+  }
+  return comp(*first, value) ? first + 1 : first;
 }
 template <class ForwardIter, class T, class Compared>
 ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value,
@@ -544,23 +875,22 @@ ForwardIter ubound_dispatch(ForwardIter first, ForwardIter last, const T &value,
   return first;
 }
 // ubound_dispatch 的 random_access_iterator_tag 版本
+// 与 lbound_dispatch 相同，使用无分支的二分查找
 template <class RandomIter, class T>
 RandomIter ubound_dispatch(RandomIter first, RandomIter last, const T &value,
                            random_access_iterator_tag) {
   auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0) {
-    half = len >> 1;
-    middle = first + half;
-    if (value < *middle) {
-      len = half;
-    } else {
-      first = middle + 1;
-      len = len - half - 1;
-    }
+  if (len == 0) {
+    return first;
   }
-  return first;
+  while (len > 1) {
+    const auto half = len / 2;
+    len -= half;
+    mystl::simd_prefetch(first + len / 2);
+    mystl::simd_prefetch(first + half + len / 2);
+    first = value < *(first + half) ? first : first + half;
+  }
+  return value < *first ? first : first + 1;
 }
 template <class ForwardIter, class T>
 ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T &value) {
@@ -595,19 +925,17 @@ template <class RandomIter, class T, class Compared>
 RandomIter ubound_dispatch(RandomIter first, RandomIter last, const T &value,
                            random_access_iterator_tag, Compared comp) {
   auto len = last - first;
-  auto half = len;
-  RandomIter middle;
-  while (len > 0) {
-    half = len >> 1;
-    middle = first + half;
-    if (comp(value, *middle)) {
-      len = half;
-    } else {
-      first = middle + 1;
-      len = len - half - 1;
-    }
+  if (len == 0) {
+    return first;
   }
-  return first;
+  while (len > 1) {
+    const auto half = len / 2;
+    len -= half;
+    mystl::simd_prefetch(first + len / 2);
+    mystl::simd_prefetch(first + half + len / 2);
+    first = comp(value, *(first + half)) ? first : first + half;
+  }
+  return comp(value, *first) ? first : first + 1;
 }
 
 template <class ForwardIter, class T, class Compared>
@@ -656,7 +984,7 @@ mystl::pair<RandomIter, RandomIter>
 erange_dispatch(RandomIter first, RandomIter last, const T &value,
                 random_access_iterator_tag) {
   auto left = mystl::lower_bound(first, last, value);
-  auto right = mystl::upper_bound(first, last, value);
+  auto right = mystl::upper_bound(left, last, value);
   return {left, right};
 }
 
@@ -788,6 +1116,128 @@ bool is_sorted(ForwardIter first, ForwardIter last, Compared comp) {
   }
   return true;
 }
+/*****************************************************************************************/
+// batch_lower_bound
+// 对 [keys_first, keys_last) 中的每个键在有序区间 [first, last) 中查找第一个
+// 不小于它的元素，结果依次写入 result，返回 result 的尾部
+// 多个查找按相同的步数同步进行，各个查找的访存互不依赖，缓存缺失互相重叠，
+// 每步再为下一轮的探测位置发出预取(只对指针有效)；键本身有序时改为从上一个
+// 结果出发的倍增查找，相当于一次归并
+/*****************************************************************************************/
+// 同步进行的查找个数
+constexpr static size_t kBatchSearchGroup = 16;
+
+template <class RandomIter, class ForwardIter, class OutputIter,
+          class Compared>
+OutputIter batch_lower_bound_interleaved(RandomIter first, RandomIter last,
+                                         ForwardIter keys_first,
+                                         ForwardIter keys_last,
+                                         OutputIter result, Compared comp) {
+  const auto n = last - first;
+  RandomIter base[kBatchSearchGroup];
+  ForwardIter key[kBatchSearchGroup];
+  while (keys_first != keys_last) {
+    size_t m = 0;
+    for (; m < kBatchSearchGroup && keys_first != keys_last;
+         ++m, ++keys_first) {
+      base[m] = first;
+      key[m] = keys_first;
+    }
+    if (n != 0) {
+      // 区间长度相同，每个查找的步数也相同
+      for (auto len = n; len > 1;) {
+        const auto half = len / 2;
+        len -= half;
+        for (size_t j = 0; j < m; ++j) {
+          base[j] = comp(*(base[j] + half), *key[j]) ? base[j] + half : base[j];
+          mystl::simd_prefetch(base[j] + len / 2);
+        }
+      }
+      for (size_t j = 0; j < m; ++j) {
+        base[j] = comp(*base[j], *key[j]) ? base[j] + 1 : base[j];
+      }
+    }
+    for (size_t j = 0; j < m; ++j) {
+      *result = base[j];
+      ++result;
+    }
+  }
+  return result;
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter,
+          class Compared>
+OutputIter batch_lower_bound_sorted(RandomIter first, RandomIter last,
+                                    ForwardIter keys_first,
+                                    ForwardIter keys_last, OutputIter result,
+                                    Compared comp) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  auto pos = first;
+  for (; keys_first != keys_last; ++keys_first) {
+    // [first, lo) 中的元素都小于当前的键，按 1, 2, 4, ... 的步长向后试探
+    auto lo = pos;
+    auto hi = last;
+    for (Distance step = 1; last - lo >= step; step *= 2) {
+      auto probe = lo + (step - 1);
+      if (!comp(*probe, *keys_first)) {
+        hi = probe;
+        break;
+      }
+      lo = probe + 1;
+    }
+    pos = mystl::lower_bound(lo, hi, *keys_first, comp);
+    *result = pos;
+    ++result;
+  }
+  return result;
+}
+
+// 键与区间元素类型相同时才能检查键是否有序
+template <class RandomIter, class ForwardIter, class OutputIter,
+          class Compared>
+OutputIter batch_lower_bound_dispatch(RandomIter first, RandomIter last,
+                                      ForwardIter keys_first,
+                                      ForwardIter keys_last, OutputIter result,
+                                      Compared comp, m_true_type) {
+  if (mystl::is_sorted(keys_first, keys_last, comp)) {
+    return mystl::batch_lower_bound_sorted(first, last, keys_first, keys_last,
+                                           result, comp);
+  }
+  return mystl::batch_lower_bound_interleaved(first, last, keys_first,
+                                              keys_last, result, comp);
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter,
+          class Compared>
+OutputIter batch_lower_bound_dispatch(RandomIter first, RandomIter last,
+                                      ForwardIter keys_first,
+                                      ForwardIter keys_last, OutputIter result,
+                                      Compared comp, m_false_type) {
+  return mystl::batch_lower_bound_interleaved(first, last, keys_first,
+                                              keys_last, result, comp);
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter,
+          class Compared>
+OutputIter batch_lower_bound(RandomIter first, RandomIter last,
+                             ForwardIter keys_first, ForwardIter keys_last,
+                             OutputIter result, Compared comp) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  typedef typename iterator_traits<ForwardIter>::value_type key_type;
+  return mystl::batch_lower_bound_dispatch(
+      first, last, keys_first, keys_last, result, comp,
+      m_bool_constant<std::is_same<value_type, key_type>::value>());
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter>
+OutputIter batch_lower_bound(RandomIter first, RandomIter last,
+                             ForwardIter keys_first, ForwardIter keys_last,
+                             OutputIter result) {
+  return mystl::batch_lower_bound(
+      first, last, keys_first, keys_last, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
 /*****************************************************************************************/
 // median
 // 找出三个值的中间值
@@ -1012,30 +1462,6 @@ void replace_if(ForwardIter first, ForwardIter last, const T &new_value,
   }
 }
 /*****************************************************************************************/
-// reverse
-// 将[first, last)区间内的元素反转
-/*****************************************************************************************/
-// reverse_dispatch 的 bidirectional_iterator_tag 版本
-template <class BidirectionalIter>
-void reverse_dispatch(BidirectionalIter first, BidirectionalIter last,
-                      mystl::bidirectional_iterator_tag) {
-  while (first != last && first != --last) {
-    mystl::iter_swap(first++, last);
-  }
-}
-// reverse_dispatch 的 random_access_iterator_tag 版本
-template <class RandomIter>
-void reverse_dispatch(RandomIter first, RandomIter last,
-                      mystl::random_access_iterator_tag) {
-  while (first < last) {
-    mystl::iter_swap(first++, --last);
-  }
-}
-template <class BidirectionalIter>
-void reverse(BidirectionalIter first, BidirectionalIter last) {
-  reverse_dispatch(first, last, iterator_category(first));
-}
-/*****************************************************************************************/
 // reverse_copy
 // 行为与 reverse 类似，不同的是将结果复制到 result 所指容器中
 /*****************************************************************************************/
@@ -1048,30 +1474,134 @@ OutputIter reverse_copy(BidirectionalIter first, BidirectionalIter last,
   return result;
 }
 /*****************************************************************************************/
-// random_shuffle
-// 将[first, last)内的元素次序随机重排
-// 重载版本使用一个产生随机数的函数对象 rand
-/*****************************************************************************************/
-template <class RandomIter>
-void random_shuffle(RandomIter first, RandomIter last) {
-  if (first == last)
-    return;
-  srand((unsigned)time(0));
+// shuffle / random_shuffle
+// 将[first, last)内的元素次序随机重排，每种排列出现的概率相同
+// shuffle 使用均匀随机位生成器 g，random_shuffle 使用当前线程的默认引擎，
+// 重载版本使用一个产生随机数的函数对象 rand，rand(n) 返回 [0, n) 内的整数
+/*****************************************************************************************/
+// 引擎输出 64 位且下标不超过 2^32 时，一个随机数生成两次交换的位置
+template <class RandomIter, class URBG>
+void shuffle_aux(RandomIter first, RandomIter last, URBG &g, m_true_type) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const auto n = static_cast<uint64_t>(last - first);
+  uint64_t i = 1;
+  const uint64_t pair_end = n < UINT32_MAX ? n : UINT32_MAX;
+  for (; i + 1 < pair_end; i += 2) {
+    uint64_t r1;
+    uint64_t r2;
+    mystl::uniform_bounded_pair(g, i + 1, i + 2, r1, r2);
+    mystl::iter_swap(first + static_cast<Distance>(i),
+                     first + static_cast<Distance>(r1));
+    mystl::iter_swap(first + static_cast<Distance>(i + 1),
+                     first + static_cast<Distance>(r2));
+  }
+  for (; i < n; ++i) {
+    mystl::iter_swap(first + static_cast<Distance>(i),
+                     first + static_cast<Distance>(
+                                 mystl::uniform_bounded(g, i + 1)));
+  }
+}
 
-  for (auto i = first + 1; i != last; ++i) {
-    mystl::iter_swap(i, first + rand() % ((i - first) + 1));
+template <class RandomIter, class URBG>
+void shuffle_aux(RandomIter first, RandomIter last, URBG &g, m_false_type) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const auto n = static_cast<uint64_t>(last - first);
+  for (uint64_t i = 1; i < n; ++i) {
+    mystl::iter_swap(first + static_cast<Distance>(i),
+                     first + static_cast<Distance>(
+                                 mystl::uniform_bounded(g, i + 1)));
   }
 }
+
+template <class RandomIter, class URBG>
+void shuffle(RandomIter first, RandomIter last, URBG &&g) {
+  if (last - first < 2)
+    return;
+  mystl::shuffle_aux(first, last, g,
+                     m_bool_constant<mystl::urbg_bits<URBG>() == 64>());
+}
+
+template <class RandomIter>
+void random_shuffle(RandomIter first, RandomIter last) {
+  mystl::shuffle(first, last, mystl::thread_random_engine());
+}
+
 // 重载版本使用一个产生随机数的函数对象 rand
 template <class RandomIter, class RandomGenerator>
 void random_shuffle(RandomIter first, RandomIter last, RandomGenerator &rand) {
   if (first == last)
     return;
-  auto len = mystl::distance(first, last);
   for (auto i = first + 1; i != last; ++i) {
-    mystl::iter_swap(i, first + (rand(i - first + 1) % len));
+    mystl::iter_swap(i, first + rand(i - first + 1));
   }
 }
+/*****************************************************************************************/
+// sample
+// 从[first, last)中无放回地随机抽取 n 个元素写入 out，区间长度不足 n 时全部写入
+// 前向迭代器使用选择抽样，结果保持原来的相对次序；
+// 输入迭代器只能遍历一次，使用 Algorithm L 蓄水池抽样，out 必须可随机访问，
+// 结果的次序是随机的。返回最后一个写入元素的下一位置
+/*****************************************************************************************/
+// sample_dispatch 的 input_iterator_tag 版本
+// 蓄水池填满后，下一个被选中的元素之前跳过的元素个数服从几何分布，
+// 直接求出跳过的个数，不必对每个元素都生成随机数
+template <class InputIter, class RandomIter, class URBG>
+RandomIter sample_dispatch(InputIter first, InputIter last, RandomIter out,
+                           uint64_t n, URBG &g, mystl::input_iterator_tag) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  uint64_t k = 0;
+  for (; first != last && k < n; ++first, ++k) {
+    *(out + static_cast<Distance>(k)) = *first;
+  }
+  if (k < n) {
+    return out + static_cast<Distance>(k);
+  }
+  const double inv = 1.0 / static_cast<double>(n);
+  double w = std::exp(std::log(mystl::uniform_real01(g)) * inv);
+  while (true) {
+    const double skip =
+        std::floor(std::log(mystl::uniform_real01(g)) / std::log1p(-w));
+    uint64_t s = skip < 0x1.0p63 ? static_cast<uint64_t>(skip) : UINT64_MAX;
+    for (; s != 0 && first != last; --s) {
+      ++first;
+    }
+    if (first == last) {
+      break;
+    }
+    *(out + static_cast<Distance>(mystl::uniform_bounded(g, n))) = *first;
+    ++first;
+    w *= std::exp(std::log(mystl::uniform_real01(g)) * inv);
+  }
+  return out + static_cast<Distance>(n);
+}
+
+// sample_dispatch 的 forward_iterator_tag 版本
+// 还剩 unsampled 个元素、还需 need 个时，当前元素以 need / unsampled 的概率入选
+template <class ForwardIter, class OutputIter, class URBG>
+OutputIter sample_dispatch(ForwardIter first, ForwardIter last,
+                           OutputIter out, uint64_t n, URBG &g,
+                           mystl::forward_iterator_tag) {
+  auto unsampled = static_cast<uint64_t>(mystl::distance(first, last));
+  uint64_t need = n < unsampled ? n : unsampled;
+  for (; need != 0; ++first, --unsampled) {
+    if (mystl::uniform_bounded(g, unsampled) < need) {
+      *out = *first;
+      ++out;
+      --need;
+    }
+  }
+  return out;
+}
+
+template <class PopulationIter, class SampleIter, class Distance, class URBG>
+SampleIter sample(PopulationIter first, PopulationIter last, SampleIter out,
+                  Distance n, URBG &&g) {
+  if (!(n > 0))
+    return out;
+  return mystl::sample_dispatch(first, last, out, static_cast<uint64_t>(n), g,
+                                iterator_category(first));
+}
+
 /*****************************************************************************************/
 // rotate
 // 将[first, middle)内的元素和 [middle,
@@ -1141,28 +1671,28 @@ RandomIter rotate_dispatch(RandomIter first, RandomIter middle, RandomIter last,
   }
   auto cycle_times = rgcd(n, l);
   for (auto i = 0; i < cycle_times; ++i) {
-    auto tmp = *first;
+    auto tmp = mystl::move(*first);
     auto p = first;
     if (l < r) {
       for (auto j = 0; j < r / cycle_times; ++j) {
         if (p > first + r) {
-          *p = *(p - r);
+          *p = mystl::move(*(p - r));
           p -= r;
         }
-        *p = *(p + l);
+        *p = mystl::move(*(p + l));
         p += l;
       }
     } else {
       for (auto j = 0; j < l / cycle_times - 1; ++j) {
         if (p < last - l) {
-          *p = *(p + l);
+          *p = mystl::move(*(p + l));
           p += l;
         }
-        *p = *(p - r);
+        *p = mystl::move(*(p - r));
         p -= r;
       }
     }
-    *p = tmp;
+    *p = mystl::move(tmp);
     ++first;
   }
   return result;
@@ -1496,7 +2026,7 @@ rotate_adaptive(BidirectionalIter1 first, BidirectionalIter1 middle,
     return mystl::copy_backward(buffer, buffer_end, last);
   } else {
     // 两段都较长，无法放入缓冲区
-    return mystl::merge_without_buffer(first, middle, last, len1, len2), first;
+    return mystl::rotate(first, middle, last);
   }
 }
 // 有缓冲区的情况下合并
@@ -1659,13 +2189,26 @@ void inplace_merge(BidirectionalIter first, BidirectionalIter middle,
 /*****************************************************************************************/
 // partial_sort
 // 对整个序列做部分排序，保证较小的 N 个元素以递增顺序置于[first, first + N)中
+// N 相对区间长度很小时用堆逐个筛选，否则先用 nth_element 选出这 N
+// 个元素再排序
 /*****************************************************************************************/
+// N 不超过区间长度的 1/kPartialSortHeapRatio 时使用堆
+constexpr static size_t kPartialSortHeapRatio = 1024;
+
+template <class RandomIter, class Compared>
+void sort(RandomIter first, RandomIter last, Compared comp);
+template <class RandomIter, class Compared>
+void nth_element(RandomIter first, RandomIter nth, RandomIter last,
+                 Compared comp);
+
+// 基于堆的部分排序，middle == last 时即为堆排序
 template <class RandomIter>
-void partial_sort(RandomIter first, RandomIter middle, RandomIter last) {
+void heap_partial_sort(RandomIter first, RandomIter middle, RandomIter last) {
   mystl::make_heap(first, middle);
   for (auto i = middle; i < last; ++i) {
     if (*i < *first) {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first));
+      mystl::pop_heap_aux(first, middle, i, mystl::move(*i),
+                          distance_type(first));
     }
   }
   mystl::sort_heap(first, middle);
@@ -1673,17 +2216,37 @@ void partial_sort(RandomIter first, RandomIter middle, RandomIter last) {
 
 // 重载版本使用函数对象 comp 代替比较操作
 template <class RandomIter, class Compared>
-void partial_sort(RandomIter first, RandomIter middle, RandomIter last,
-                  Compared comp) {
-  mystl::make_heap(first, middle);
+void heap_partial_sort(RandomIter first, RandomIter middle, RandomIter last,
+                       Compared comp) {
+  mystl::make_heap(first, middle, comp);
   for (auto i = middle; i < last; ++i) {
     if (comp(*i, *first)) {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first), comp);
+      mystl::pop_heap_aux(first, middle, i, mystl::move(*i),
+                          distance_type(first), comp);
     }
   }
   mystl::sort_heap(first, middle, comp);
 }
 
+template <class RandomIter, class Compared>
+void partial_sort(RandomIter first, RandomIter middle, RandomIter last,
+                  Compared comp) {
+  const auto n = static_cast<size_t>(last - first);
+  const auto k = static_cast<size_t>(middle - first);
+  if (k <= n / kPartialSortHeapRatio) {
+    mystl::heap_partial_sort(first, middle, last, comp);
+    return;
+  }
+  mystl::nth_element(first, middle, last, comp);
+  mystl::sort(first, middle, comp);
+}
+
+template <class RandomIter>
+void partial_sort(RandomIter first, RandomIter middle, RandomIter last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::partial_sort(first, middle, last, mystl::less<value_type>());
+}
+
 /*****************************************************************************************/
 // partial_sort_copy
 // 行为与 partial_sort 类似，不同的是把排序结果复制到 result 容器中
@@ -1699,7 +2262,7 @@ RandomIter psort_copy_aux(InputIter first, InputIter last,
   while (first != last && result_iter != resutl_last) {
     *result_iter++ = *first++;
   }
-  mystl::make_heap(result_first, resutl_last);
+  mystl::make_heap(result_first, result_iter);
   while (first != last) {
     if (*first < *result_first) {
       mystl::adjust_heap(result_first, static_cast<Distance>(0),
@@ -1730,7 +2293,7 @@ RandomIter psort_copy_aux(InputIter first, InputIter last,
   while (first != last && result_iter != resutl_last) {
     *result_iter++ = *first++;
   }
-  mystl::make_heap(result_first, resutl_last);
+  mystl::make_heap(result_first, result_iter, comp);
   while (first != last) {
     if (comp(*first, *result_first)) {
       mystl::adjust_heap(result_first, static_cast<Distance>(0),
@@ -1839,7 +2402,7 @@ void intro_sort(RandomIter first, RandomIter last, Size depth_limit) {
   while (static_cast<size_t>(last - first) > kSmallSectionSize) {
     if (depth_limit == 0) {
       // 到达最大分割深度限制
-      mystl::partial_sort(first, last, last); // 改用heap_sort
+      mystl::heap_partial_sort(first, last, last); // 改用heap_sort
       return;
     }
     --depth_limit;
@@ -1868,7 +2431,8 @@ void unchecked_linear_insert(RandomIter last, const T &value) {
 template <class RandomIter>
 void unchecked_insertion_sort(RandomIter first, RandomIter last) {
   for (auto i = first; i != last; ++i) {
-    mystl::unchecked_linear_insert(i, *i);
+    auto value = *i; // *i 会在插入过程中被覆盖，需要先取出
+    mystl::unchecked_linear_insert(i, value);
   }
 }
 
@@ -1930,13 +2494,13 @@ template <class RandomIter, class Size, class Compared>
 void intro_sort(RandomIter first, RandomIter last, Size depth_limit,
                 Compared comp) {
   while (static_cast<size_t>(last - first) > kSmallSectionSize) {
-    if (depth_limit == 0) {                         // 到达最大分割深度限制
-      mystl::partial_sort(first, last, last, comp); // 改用 heap_sort
+    if (depth_limit == 0) { // 到达最大分割深度限制
+      mystl::heap_partial_sort(first, last, last, comp); // 改用 heap_sort
       return;
     }
     --depth_limit;
-    auto mid =
-        mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
+    auto mid = mystl::median(*(first), *(first + (last - first) / 2),
+                             *(last - 1), comp);
     auto cut = mystl::unchecked_partition(first, last, mid, comp);
     mystl::intro_sort(cut, last, depth_limit, comp);
     last = cut;
@@ -1961,7 +2525,8 @@ template <class RandomIter, class Compared>
 void unchecked_insertion_sort(RandomIter first, RandomIter last,
                               Compared comp) {
   for (auto i = first; i != last; ++i) {
-    mystl::unchecked_linear_insert(i, *i, comp);
+    auto value = *i;
+    mystl::unchecked_linear_insert(i, value, comp);
   }
 }
 
@@ -2005,43 +2570,228 @@ void sort(RandomIter first, RandomIter last, Compared comp) {
 // nth_element
 // 对序列重排，使得所有小于第 n
 // 个元素的元素出现在它的前面，大于它的出现在它的后面
-/*****************************************************************************************/
-template <class RandomIter>
-void nth_element(RandomIter first, RandomIter nth, RandomIter last) {
-  if (nth == last) {
-    return;
+// 采用内省式选择(introselect)：小区间用三点中值，大区间用 Floyd-Rivest
+// 抽样选取枢轴。每 kSelectProgressRounds 次分割区间至少要缩小一半，否则
+// (或分割深度超过限制时)改用中位数的中位数，之后每次分割至少去掉 3/10 的元素，
+// 所以最坏情况为线性时间
+/*****************************************************************************************/
+// 长度不超过该值的区间直接做插入排序
+constexpr static size_t kSelectSmallSize = 16;
+// 每隔这么多次分割检查一次区间是否已缩小到一半以下
+constexpr static size_t kSelectProgressRounds = 3;
+// 长度超过该值的区间用 Floyd-Rivest 抽样选取枢轴
+constexpr static size_t kFloydRivestSize = 600;
+
+template <class RandomIter, class Compared>
+void intro_select(RandomIter first, RandomIter nth, RandomIter last,
+                  size_t depth_limit, Compared comp);
+
+// 返回三个位置中值为中位数的那个位置
+template <class RandomIter, class Compared>
+RandomIter median_iter(RandomIter a, RandomIter b, RandomIter c,
+                       Compared comp) {
+  if (comp(*a, *b)) {
+    if (comp(*b, *c))
+      return b;
+    return comp(*a, *c) ? c : a;
   }
-  while (last - first > 3) {
-    auto cut = mystl::unchecked_partition(
-        first, last,
-        mystl::median(*first, *(first + (last - first) / 2), *(last - 1)));
-    if (cut <= nth) // 如果nth处于右段
-    {
-      first = cut; // 对右段进行分割
-    } else {
-      last = cut; // 对左段进行分割
+  if (comp(*a, *c))
+    return a;
+  return comp(*b, *c) ? c : b;
+}
+
+// 以 pivot 处的元素为枢轴分割 [first, last)，返回枢轴的最终位置 p，
+// 使得 [first, p) 中的元素不大于枢轴，(p, last) 中的元素不小于枢轴
+template <class RandomIter, class Compared>
+RandomIter select_partition(RandomIter first, RandomIter last,
+                            RandomIter pivot, Compared comp) {
+  mystl::iter_swap(first, pivot);
+  auto i = first + 1;
+  auto j = last - 1;
+  while (true) {
+    while (i <= j && comp(*i, *first))
+      ++i;
+    while (i <= j && comp(*first, *j))
+      --j;
+    if (!(i < j))
+      break;
+    mystl::iter_swap(i, j);
+    ++i;
+    --j;
+  }
+  mystl::iter_swap(first, j);
+  return j;
+}
+
+// 中位数的中位数：每 5 个元素取中位数并移到区间前部，再递归选出它们的中位数
+template <class RandomIter, class Compared>
+RandomIter median_of_medians(RandomIter first, RandomIter last,
+                             Compared comp) {
+  auto store = first;
+  for (auto group = first; last - group >= 5; group += 5) {
+    mystl::insertion_sort(group, group + 5, comp);
+    mystl::iter_swap(store++, group + 2);
+  }
+  if (store == first) {
+    return first;
+  }
+  auto mid = first + (store - first) / 2;
+  mystl::intro_select(first, mid, store, 0, comp);
+  return mid;
+}
+
+// Floyd-Rivest：先在 nth 附近的子区间中递归选择，使 nth 处的元素接近目标，
+// 再以它作为枢轴
+template <class RandomIter, class Compared>
+RandomIter floyd_rivest_pivot(RandomIter first, RandomIter nth,
+                              RandomIter last, size_t depth_limit,
+                              Compared comp) {
+  const double n = static_cast<double>(last - first);
+  const double k = static_cast<double>(nth - first);
+  const double z = std::log(n);
+  const double s = 0.5 * std::exp(2.0 * z / 3.0);
+  double sd = 0.5 * std::sqrt(z * s * (n - s) / n);
+  if (k < n / 2) {
+    sd = -sd;
+  }
+  const double lo = k - k * s / n + sd;
+  const double hi = k + (n - k) * s / n + sd;
+  auto sub_first = lo > 0 ? first + static_cast<ptrdiff_t>(lo) : first;
+  auto sub_last = hi < n ? first + static_cast<ptrdiff_t>(hi) + 1 : last;
+  if (sub_first > nth)
+    sub_first = nth;
+  if (sub_last <= nth)
+    sub_last = nth + 1;
+  mystl::intro_select(sub_first, nth, sub_last, depth_limit, comp);
+  return nth;
+}
+
+// 为目标位置 nth 选取枢轴，并消耗一次分割深度
+template <class RandomIter, class Compared>
+RandomIter select_pivot(RandomIter first, RandomIter nth, RandomIter last,
+                        size_t &depth_limit, Compared comp) {
+  if (depth_limit == 0) {
+    // 分割进展太慢或到达最大分割深度限制，改用保证线性时间的枢轴
+    return mystl::median_of_medians(first, last, comp);
+  }
+  --depth_limit;
+  const auto n = static_cast<size_t>(last - first);
+  if (n > kFloydRivestSize) {
+    return mystl::floyd_rivest_pivot(first, nth, last, depth_limit, comp);
+  }
+  return mystl::median_iter(first, first + n / 2, last - 1, comp);
+}
+
+template <class RandomIter, class Compared>
+void intro_select(RandomIter first, RandomIter nth, RandomIter last,
+                  size_t depth_limit, Compared comp) {
+  auto checkpoint = static_cast<size_t>(last - first);
+  size_t rounds = 0;
+  while (static_cast<size_t>(last - first) > kSelectSmallSize) {
+    auto pivot =
+        mystl::select_pivot(first, nth, last, depth_limit, comp);
+    auto cut = mystl::select_partition(first, last, pivot, comp);
+    if (cut == nth)
+      return;
+    if (cut < nth)
+      first = cut + 1;
+    else
+      last = cut;
+    if (++rounds == kSelectProgressRounds) {
+      const auto n = static_cast<size_t>(last - first);
+      if (n > checkpoint / 2) {
+        depth_limit = 0;
+      }
+      checkpoint = n;
+      rounds = 0;
     }
   }
-  mystl::insertion_sort(first, last);
+  mystl::insertion_sort(first, last, comp);
 }
 
-// 重载版本使用函数对象 comp 代替比较操作
 template <class RandomIter, class Compared>
 void nth_element(RandomIter first, RandomIter nth, RandomIter last,
                  Compared comp) {
   if (nth == last)
     return;
-  while (last - first > 3) {
-    auto cut = mystl::unchecked_partition(
-        first, last,
-        mystl::median(*first, *(first + (last - first) / 2), *(last - 1)),
-        comp);
-    if (cut <= nth) // 如果 nth 位于右段
-      first = cut;  // 对右段进行分割
-    else
-      last = cut; // 对左段进行分割
+  mystl::intro_select(first, nth, last, slg2(last - first) * 2, comp);
+}
+
+template <class RandomIter>
+void nth_element(RandomIter first, RandomIter nth, RandomIter last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::nth_element(first, nth, last, mystl::less<value_type>());
+}
+
+/*****************************************************************************************/
+// nth_elements
+// 一次把多个位置上的元素放到排序后应在的位置，[nth_first, nth_last)
+// 为这些位置相对 first 的下标，无需有序，超出区间的下标被忽略。
+// 每次以中间的目标位置选取枢轴，只继续分割含有目标位置的一侧，
+// 比逐个调用 nth_element 少做很多次重复的分割
+/*****************************************************************************************/
+// origin 为整个区间的起点，[rfirst, rlast) 为有序且不重复的目标下标
+template <class RandomIter, class Compared>
+void multi_select(RandomIter origin, RandomIter first, RandomIter last,
+                  const size_t *rfirst, const size_t *rlast,
+                  size_t depth_limit, Compared comp) {
+  while (rfirst != rlast) {
+    if (static_cast<size_t>(last - first) <= kSelectSmallSize) {
+      mystl::insertion_sort(first, last, comp);
+      return;
+    }
+    if (rlast - rfirst == 1) {
+      mystl::intro_select(first, origin + *rfirst, last, depth_limit, comp);
+      return;
+    }
+    auto nth = origin + rfirst[(rlast - rfirst) / 2];
+    auto pivot = mystl::select_pivot(first, nth, last, depth_limit, comp);
+    auto cut = mystl::select_partition(first, last, pivot, comp);
+    const auto c = static_cast<size_t>(cut - origin);
+    auto rmid = mystl::lower_bound(rfirst, rlast, c);
+    auto rnext = rmid != rlast && *rmid == c ? rmid + 1 : rmid;
+    mystl::multi_select(origin, first, cut, rfirst, rmid, depth_limit, comp);
+    first = cut + 1;
+    rfirst = rnext;
   }
-  mystl::insertion_sort(first, last, comp);
+}
+
+template <class RandomIter, class ForwardIter, class Compared>
+void nth_elements(RandomIter first, RandomIter last, ForwardIter nth_first,
+                  ForwardIter nth_last, Compared comp) {
+  const auto n = static_cast<size_t>(last - first);
+  const auto k = static_cast<size_t>(mystl::distance(nth_first, nth_last));
+  if (k == 0) {
+    return;
+  }
+  mystl::vector<size_t> ranks;
+  ranks.reserve(k);
+  for (; nth_first != nth_last; ++nth_first) {
+    const auto r = static_cast<size_t>(*nth_first);
+    if (r < n) {
+      ranks.push_back(r);
+    }
+  }
+  if (ranks.empty()) {
+    return;
+  }
+  mystl::sort(ranks.begin(), ranks.end());
+  size_t unique_count = 1;
+  for (size_t i = 1; i < ranks.size(); ++i) {
+    if (ranks[i] != ranks[unique_count - 1]) {
+      ranks[unique_count++] = ranks[i];
+    }
+  }
+  mystl::multi_select(first, first, last, ranks.begin(),
+                      ranks.begin() + unique_count, slg2(n) * 2, comp);
+}
+
+template <class RandomIter, class ForwardIter>
+void nth_elements(RandomIter first, RandomIter last, ForwardIter nth_first,
+                  ForwardIter nth_last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::nth_elements(first, last, nth_first, nth_last,
+                      mystl::less<value_type>());
 }
 
 /*****************************************************************************************/
@@ -4,6 +4,7 @@
 #include <cstring>
 
 #include "iterator.h"
+#include "simd.h"
 #include "util.h"
 
 namespace mystl {
@@ -40,6 +41,31 @@ template <class FIter1, class FIter2> void iter_swap(FIter1 a, FIter2 b) {
   mystl::swap(*a, *b);
 }
 
+/*****************************************************************************************/
+// reverse
+// 将[first, last)区间内的元素反转
+/*****************************************************************************************/
+// reverse_dispatch 的 bidirectional_iterator_tag 版本
+template <class BidirectionalIter>
+void reverse_dispatch(BidirectionalIter first, BidirectionalIter last,
+                      mystl::bidirectional_iterator_tag) {
+  while (first != last && first != --last) {
+    mystl::iter_swap(first++, last);
+  }
+}
+// reverse_dispatch 的 random_access_iterator_tag 版本
+template <class RandomIter>
+void reverse_dispatch(RandomIter first, RandomIter last,
+                      mystl::random_access_iterator_tag) {
+  while (first < last) {
+    mystl::iter_swap(first++, --last);
+  }
+}
+template <class BidirectionalIter>
+void reverse(BidirectionalIter first, BidirectionalIter last) {
+  reverse_dispatch(first, last, iterator_category(first));
+}
+
 template <class InputIter, class OutputIter>
 OutputIter unchecked_copy_cat(InputIter first, InputIter last,
                               OutputIter result, mystl::input_iterator_tag) {
@@ -77,11 +103,6 @@ unchecked_copy(Tp *first, Tp *last, Up *result) {
   return result + n;
 }
 
-template <class InputIter, class OutputIter>
-OutputIter copy(InputIter first, InputIter last, OutputIter result) {
-  return unchecked_copy(first, last, result);
-}
-
 template <class BidirectionalIter1, class BidirectionalIter2>
 BidirectionalIter2
 unchecked_copy_backward_cat(BidirectionalIter1 first, BidirectionalIter1 last,
@@ -117,7 +138,7 @@ typename std::enable_if<
     std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
         std::is_trivially_copy_assignable<Up>::value,
     Up *>::type
-unchecked_copy_backward(Tp first, Tp last, Up result) {
+unchecked_copy_backward(Tp *first, Tp *last, Up *result) {
   const auto n = static_cast<size_t>(last - first);
   if (n != 0) {
     result -= n;
@@ -126,13 +147,6 @@ unchecked_copy_backward(Tp first, Tp last, Up result) {
   return result;
 }
 
-template <class BidirectionalIter1, class BidirectionalIter2>
-BidirectionalIter2 copy_backward(BidirectionalIter1 first,
-                                 BidirectionalIter1 last,
-                                 BidirectionalIter2 result) {
-  return unchecked_copy_backward(first, last, result);
-}
-
 template <class InputIter, class OutputIter, class UnaryPredicate>
 OutputIter copy_if(InputIter first, InputIter last, OutputIter result,
                    UnaryPredicate unary_pred) {
@@ -143,30 +157,6 @@ OutputIter copy_if(InputIter first, InputIter last, OutputIter result,
   return result;
 }
 
-template <class InputIter, class Size, class OutputIter>
-mystl::pair<InputIter, OutputIter> unchecked_copy_n(InputIter first, Size n,
-                                                    OutputIter result,
-                                                    mystl::input_iterator_tag) {
-  for (; n > 0; --n, ++first, ++result) {
-    *result = *first;
-  }
-  return mystl::make_pair(first, result);
-}
-
-template <class RandomIter, class Size, class OutputIter>
-mystl::pair<RandomIter, OutputIter>
-unchecked_copy_n(RandomIter first, Size n, OutputIter result,
-                 mystl::random_access_iterator_tag) {
-  auto last = first + n;
-  return mystl::make_pair(last, copy(first, last, result));
-}
-
-template <class InputIter, class Size, class OutputIter>
-mystl::pair<InputIter, OutputIter> copy_n(InputIter first, Size n,
-                                          OutputIter result) {
-  return unchecked_copy_n(first, n, result, iterator_category(first));
-}
-
 /********************************************************************/
 // move
 // 把[first, last)区间的元素移动到result中
@@ -207,12 +197,7 @@ unchecked_move(Tp *first, Tp *last, Up *result) {
   if (n != 0) {
     std::memmove(result, first, n * sizeof(Up));
   }
-  return result;
-}
-
-template <class InputIter, class OutputIter>
-OutputIter move(InputIter first, InputIter last, OutputIter result) {
-  return unchecked_move(first, last, result);
+  return result + n;
 }
 
 /************************************************************************* */
@@ -246,7 +231,7 @@ template <class BidirectionalIter1, class BidirectionalIter2>
 BidirectionalIter2 unchecked_move_backward(BidirectionalIter1 first,
                                            BidirectionalIter1 last,
                                            BidirectionalIter2 result) {
-  return unchecked_copy_backward_cat(first, last, result,
+  return unchecked_move_backward_cat(first, last, result,
                                      iterator_category(first));
 }
 
@@ -259,16 +244,199 @@ typename std::enable_if<
 unchecked_move_backward(Tp *first, Tp *last, Up *result) {
   const size_t n = static_cast<size_t>(last - first);
   if (n != 0) {
+    result -= n;
     std::memmove(result, first, n * sizeof(Up));
   }
   return result;
 }
 
+/*****************************************************************************************/
+// 分段迭代器的 copy / copy_backward / move / move_backward
+// 来源为分段迭代器时按来源的段拆开；目标为分段迭代器且来源可随机访问时
+// 按目标的段拆开。每段交给段内迭代器的版本，deque 的段内迭代器为指针，
+// 元素可平凡拷贝时每段只需一次 memmove
+/*****************************************************************************************/
+// 复制或移动，Move 为 m_true_type 时移动
+template <class InputIter, class OutputIter>
+OutputIter unchecked_copy_or_move(InputIter first, InputIter last,
+                                  OutputIter result, m_false_type) {
+  return unchecked_copy(first, last, result);
+}
+
+template <class InputIter, class OutputIter>
+OutputIter unchecked_copy_or_move(InputIter first, InputIter last,
+                                  OutputIter result, m_true_type) {
+  return unchecked_move(first, last, result);
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2>
+BidirectionalIter2 unchecked_copy_or_move_backward(BidirectionalIter1 first,
+                                                   BidirectionalIter1 last,
+                                                   BidirectionalIter2 result,
+                                                   m_false_type) {
+  return unchecked_copy_backward(first, last, result);
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2>
+BidirectionalIter2 unchecked_copy_or_move_backward(BidirectionalIter1 first,
+                                                   BidirectionalIter1 last,
+                                                   BidirectionalIter2 result,
+                                                   m_true_type) {
+  return unchecked_move_backward(first, last, result);
+}
+
+// 目标为分段迭代器
+template <class RandomIter, class SegIter, class Move>
+SegIter segmented_copy_out(RandomIter first, RandomIter last, SegIter result,
+                           Move move, mystl::random_access_iterator_tag) {
+  return mystl::for_each_output_segment(
+      first, last, result, [move](RandomIter f, RandomIter l, auto out) {
+        return mystl::unchecked_copy_or_move(f, l, out, move);
+      });
+}
+
+template <class InputIter, class SegIter, class Move>
+SegIter segmented_copy_out(InputIter first, InputIter last, SegIter result,
+                           Move move, mystl::input_iterator_tag) {
+  return mystl::unchecked_copy_or_move(first, last, result, move);
+}
+
+template <class InputIter, class OutputIter, class Move>
+OutputIter segmented_copy(InputIter first, InputIter last, OutputIter result,
+                          Move move, m_false_type, m_false_type) {
+  return mystl::unchecked_copy_or_move(first, last, result, move);
+}
+
+template <class InputIter, class OutputIter, class Move>
+OutputIter segmented_copy(InputIter first, InputIter last, OutputIter result,
+                          Move move, m_false_type, m_true_type) {
+  return mystl::segmented_copy_out(first, last, result, move,
+                                   iterator_category(first));
+}
+
+// 来源为分段迭代器，段内迭代器不再分段
+template <class SegIter, class OutputIter, class Move, class OutSeg>
+OutputIter segmented_copy(SegIter first, SegIter last, OutputIter result,
+                          Move move, m_true_type, OutSeg) {
+  mystl::for_each_segment(first, last, [&](auto, auto f, auto l) {
+    result = mystl::segmented_copy(f, l, result, move, m_false_type(),
+                                   OutSeg());
+    return false;
+  });
+  return result;
+}
+
+template <class RandomIter, class SegIter, class Move>
+SegIter segmented_copy_backward_out(RandomIter first, RandomIter last,
+                                    SegIter result, Move move,
+                                    mystl::random_access_iterator_tag) {
+  return mystl::for_each_output_segment_backward(
+      first, last, result, [move](RandomIter f, RandomIter l, auto out) {
+        return mystl::unchecked_copy_or_move_backward(f, l, out, move);
+      });
+}
+
+template <class BidirectionalIter, class SegIter, class Move>
+SegIter segmented_copy_backward_out(BidirectionalIter first,
+                                    BidirectionalIter last, SegIter result,
+                                    Move move,
+                                    mystl::bidirectional_iterator_tag) {
+  return mystl::unchecked_copy_or_move_backward(first, last, result, move);
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2, class Move>
+BidirectionalIter2
+segmented_copy_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+                        BidirectionalIter2 result, Move move, m_false_type,
+                        m_false_type) {
+  return mystl::unchecked_copy_or_move_backward(first, last, result, move);
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2, class Move>
+BidirectionalIter2
+segmented_copy_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+                        BidirectionalIter2 result, Move move, m_false_type,
+                        m_true_type) {
+  return mystl::segmented_copy_backward_out(first, last, result, move,
+                                            iterator_category(first));
+}
+
+template <class SegIter, class BidirectionalIter, class Move, class OutSeg>
+BidirectionalIter segmented_copy_backward(SegIter first, SegIter last,
+                                          BidirectionalIter result, Move move,
+                                          m_true_type, OutSeg) {
+  mystl::for_each_segment_backward(first, last, [&](auto, auto f, auto l) {
+    result = mystl::segmented_copy_backward(f, l, result, move,
+                                            m_false_type(), OutSeg());
+    return false;
+  });
+  return result;
+}
+
+/*****************************************************************************************/
+// copy / copy_backward / move / move_backward
+/*****************************************************************************************/
+template <class InputIter, class OutputIter>
+OutputIter copy(InputIter first, InputIter last, OutputIter result) {
+  return mystl::segmented_copy(first, last, result, m_false_type(),
+                               is_segmented_iterator<InputIter>(),
+                               is_segmented_iterator<OutputIter>());
+}
+
+template <class BidirectionalIter1, class BidirectionalIter2>
+BidirectionalIter2 copy_backward(BidirectionalIter1 first,
+                                 BidirectionalIter1 last,
+                                 BidirectionalIter2 result) {
+  return mystl::segmented_copy_backward(
+      first, last, result, m_false_type(),
+      is_segmented_iterator<BidirectionalIter1>(),
+      is_segmented_iterator<BidirectionalIter2>());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter move(InputIter first, InputIter last, OutputIter result) {
+  return mystl::segmented_copy(first, last, result, m_true_type(),
+                               is_segmented_iterator<InputIter>(),
+                               is_segmented_iterator<OutputIter>());
+}
+
 template <class BidirectionalIter1, class BidirectionalIter2>
 BidirectionalIter2 move_backward(BidirectionalIter1 first,
                                  BidirectionalIter1 last,
                                  BidirectionalIter2 result) {
-  return unchecked_move_backward(first, last, result);
+  return mystl::segmented_copy_backward(
+      first, last, result, m_true_type(),
+      is_segmented_iterator<BidirectionalIter1>(),
+      is_segmented_iterator<BidirectionalIter2>());
+}
+
+/*****************************************************************************************/
+// copy_n
+// 把 [first, first + n) 复制到以 result 为起始处的空间，返回一对迭代器，
+// 分别指向两个区间的尾部
+/*****************************************************************************************/
+template <class InputIter, class Size, class OutputIter>
+mystl::pair<InputIter, OutputIter> unchecked_copy_n(InputIter first, Size n,
+                                                    OutputIter result,
+                                                    mystl::input_iterator_tag) {
+  for (; n > 0; --n, ++first, ++result) {
+    *result = *first;
+  }
+  return mystl::make_pair(first, result);
+}
+
+template <class RandomIter, class Size, class OutputIter>
+mystl::pair<RandomIter, OutputIter>
+unchecked_copy_n(RandomIter first, Size n, OutputIter result,
+                 mystl::random_access_iterator_tag) {
+  auto last = first + n;
+  return mystl::make_pair(last, copy(first, last, result));
+}
+
+template <class InputIter, class Size, class OutputIter>
+mystl::pair<InputIter, OutputIter> copy_n(InputIter first, Size n,
+                                          OutputIter result) {
+  return unchecked_copy_n(first, n, result, iterator_category(first));
 }
 
 /*********************************************************** */
@@ -285,6 +453,22 @@ bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
   return true;
 }
 
+// 为算术类型的指针提供特化版本，整数按字节比较，浮点数使用向量化比较
+template <class Tp, class Up>
+typename std::enable_if<
+    is_simd_value<typename std::remove_const<Tp>::type>::value &&
+        std::is_same<typename std::remove_const<Tp>::type,
+                     typename std::remove_const<Up>::type>::value,
+    bool>::type
+equal(Tp *first1, Tp *last1, Up *first2) {
+  const auto n = static_cast<size_t>(last1 - first1);
+  if (std::is_integral<typename std::remove_const<Tp>::type>::value) {
+    return n == 0 || std::memcmp(first1, first2, n * sizeof(Tp)) == 0;
+  }
+  return mystl::simd_mismatch<typename std::remove_const<Tp>::type>(
+             first1, first2, n) == n;
+}
+
 // 重载版本使用函数对象comp代替比较操作
 template <class InputIter1, class InputIter2, class Compared>
 bool equal(InputIter1 first1, InputIter1 last1, InputIter2 first2,
@@ -321,11 +505,46 @@ unchecked_fill_n(Tp *first, Size n, Up value) {
   return first + n;
 }
 
+// 为其余可平凡拷贝的类型提供特化版本，使用向量化的填充
+template <class Tp, class Size, class Up>
+typename std::enable_if<
+    is_simd_fill_value<Tp>::value &&
+        (std::is_same<Tp, Up>::value ||
+         (std::is_arithmetic<Tp>::value && std::is_arithmetic<Up>::value)),
+    Tp *>::type
+unchecked_fill_n(Tp *first, Size n, const Up &value) {
+  if (n > 0) {
+    mystl::simd_fill(first, static_cast<size_t>(n), static_cast<Tp>(value));
+  }
+  return first + n;
+}
+
+// 目标为分段迭代器时逐段填充
 template <class OutputIter, class Size, class T>
-OutputIter fill_n(OutputIter first, Size n, const T &value) {
+OutputIter fill_n_dispatch(OutputIter first, Size n, const T &value,
+                           m_false_type) {
   return unchecked_fill_n(first, n, value);
 }
 
+template <class SegIter, class Size, class T>
+SegIter fill_n_dispatch(SegIter first, Size n, const T &value, m_true_type) {
+  if (n <= 0) {
+    return first;
+  }
+  const SegIter last = first + n;
+  mystl::for_each_segment(first, last, [&value](auto, auto f, auto l) {
+    unchecked_fill_n(f, l - f, value);
+    return false;
+  });
+  return last;
+}
+
+template <class OutputIter, class Size, class T>
+OutputIter fill_n(OutputIter first, Size n, const T &value) {
+  return mystl::fill_n_dispatch(first, n, value,
+                                is_segmented_iterator<OutputIter>());
+}
+
 /******************************************************************* */
 // fill
 // 为[first,last)区间内的所有元素填充新值
@@ -340,7 +559,7 @@ void fill_cat(ForwardIter first, ForwardIter last, const T &value,
 template <class RandomIter, class T>
 void fill_cat(RandomIter first, RandomIter last, const T &value,
               mystl::random_access_iterator_tag) {
-  fill_n(first, last - first, value);
+  mystl::fill_n(first, last - first, value);
 }
 
 template <class ForwardIter, class T>
@@ -413,6 +632,19 @@ mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2) {
   return mystl::make_pair(first1, first2);
 }
 
+// 为算术类型的指针提供向量化版本
+template <class Tp, class Up>
+typename std::enable_if<
+    is_simd_value<typename std::remove_const<Tp>::type>::value &&
+        std::is_same<typename std::remove_const<Tp>::type,
+                     typename std::remove_const<Up>::type>::value,
+    mystl::pair<Tp *, Up *>>::type
+mismatch(Tp *first1, Tp *last1, Up *first2) {
+  const size_t i = mystl::simd_mismatch<typename std::remove_const<Tp>::type>(
+      first1, first2, static_cast<size_t>(last1 - first1));
+  return mystl::pair<Tp *, Up *>(first1 + i, first2 + i);
+}
+
 // 重载版本使用函数对象 comp 代替比较操作
 template <class InputIter1, class InputIter2, class Compared>
 mystl::pair<InputIter1, InputIter2> mismatch(InputIter1 first1,
@@ -5,9 +5,11 @@
 
 #include "algo.h"
 #include "algobase.h"
-// #include "set_algo.h"
+#include "set_algo.h"
 #include "heap_algo.h"
-// #include "numeric.h"
+#include "parallel_algo.h"
+#include "searcher.h"
+#include "numeric.h"
 
 namespace mystl {} // namespace mystl
 
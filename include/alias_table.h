@@ -0,0 +1,105 @@
+#ifndef MYTINYSTL_ALIAS_TABLE_H_
+#define MYTINYSTL_ALIAS_TABLE_H_
+
+// 这个头文件包含一个类 alias_table
+// alias_table : 按给定权重抽取下标的别名表
+
+// notes:
+//
+// 用 Vose 的方法在 O(n) 时间内建表：把每个权重缩放为平均值 1，
+// 不足 1 的列用一个超过 1 的列补满，补入的列记为该列的别名。
+// 抽取时先均匀地选一列，再用一个随机数决定取这一列本身还是它的别名，
+// 每次抽取 O(1)。概率以 64 位整数阈值存放，抽取时不做浮点运算；
+// 完整的列阈值为 UINT64_MAX 且别名为自身，不会因舍入选到别的列
+
+#include <cstddef>
+#include <cstdint>
+
+#include "exceptdef.h"
+#include "iterator.h"
+#include "random.h"
+#include "vector.h"
+
+namespace mystl {
+
+class alias_table {
+public:
+  typedef size_t size_type;
+
+private:
+  mystl::vector<uint64_t> threshold_; // 取本列的概率乘以 2^64
+  mystl::vector<size_type> alias_;    // 每列的别名
+
+public:
+  alias_table() = default;
+
+  // [first, last) 为各下标的权重，必须非负且不全为零
+  template <class InputIter> alias_table(InputIter first, InputIter last) {
+    assign(first, last);
+  }
+
+  template <class InputIter> void assign(InputIter first, InputIter last);
+
+  bool empty() const noexcept { return alias_.empty(); }
+  size_type size() const noexcept { return alias_.size(); }
+
+  // 按权重随机返回 [0, size()) 中的一个下标
+  template <class URBG> size_type operator()(URBG &g) const {
+    MYSTL_DEBUG(!empty());
+    const auto i =
+        static_cast<size_type>(mystl::uniform_bounded(g, alias_.size()));
+    return mystl::random_bits<64>(g) < threshold_[i] ? i : alias_[i];
+  }
+
+private:
+  static uint64_t to_threshold(double p) noexcept {
+    const double x = p * 0x1.0p64;
+    return x >= 0x1.0p64 ? UINT64_MAX : static_cast<uint64_t>(x);
+  }
+};
+
+template <class InputIter>
+void alias_table::assign(InputIter first, InputIter last) {
+  threshold_.clear();
+  alias_.clear();
+  mystl::vector<double> scaled;
+  double sum = 0;
+  for (; first != last; ++first) {
+    const auto w = static_cast<double>(*first);
+    MYSTL_DEBUG(w >= 0);
+    scaled.push_back(w);
+    sum += w;
+  }
+  if (scaled.empty()) {
+    return;
+  }
+  MYSTL_DEBUG(sum > 0);
+  const size_type n = scaled.size();
+  const double factor = static_cast<double>(n) / sum;
+  mystl::vector<size_type> small;
+  mystl::vector<size_type> large;
+  threshold_.reserve(n);
+  alias_.reserve(n);
+  for (size_type i = 0; i < n; ++i) {
+    scaled[i] *= factor;
+    (scaled[i] < 1.0 ? small : large).push_back(i);
+    threshold_.push_back(UINT64_MAX);
+    alias_.push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    const size_type s = small.back();
+    small.pop_back();
+    const size_type l = large.back();
+    threshold_[s] = to_threshold(scaled[s]);
+    alias_[s] = l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // 剩下的列只差舍入误差，视为完整的列，保持阈值为 UINT64_MAX、别名为自身
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_ALIAS_TABLE_H_
@@ -0,0 +1,453 @@
+#ifndef MYTINYSTL_CONCURRENT_QUEUE_H_
+#define MYTINYSTL_CONCURRENT_QUEUE_H_
+
+// 这个头文件包含一个模板类 concurrent_queue
+// concurrent_queue : 无界的多生产者多消费者并发队列
+
+// notes:
+//
+// concurrent_queue 由若干固定大小的段(segment)组成一条单向链表，与 deque
+// 的缓冲区类似。每个段内有一组槽位以及原子的入队/出队下标，生产者和消费者
+// 通过 fetch_add 争抢槽位，只有在段用尽时才需要在链表上做 CAS。
+// 被摘下的段经过 hazard pointer 检查后放入空闲链表，之后追加新段时优先复用，
+// 因此在稳定状态下入队与出队都不会进行内存分配。
+//
+// 若消费者抢到了一个生产者已占用但尚未写完的槽位，它会短暂自旋等待写入完成。
+//
+// hazard pointer 记录以 CAS 追加到单向链表中，没有空闲记录时追加新记录而不是
+// 等待，所以同时访问的线程数没有上限。记录在队列析构时才释放。
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+
+#include "algobase.h"
+#include "construct.h"
+#include "util.h"
+
+namespace mystl {
+
+// 每个段所含的槽位数
+#ifndef CONCURRENT_QUEUE_SEGMENT_SIZE
+#define CONCURRENT_QUEUE_SEGMENT_SIZE 128
+#endif
+
+// 模板类 concurrent_queue
+// 模板参数 T 代表数据类型
+template <class T> class concurrent_queue {
+public:
+  typedef T value_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef size_t size_type;
+
+  static constexpr size_type segment_size = CONCURRENT_QUEUE_SEGMENT_SIZE;
+
+private:
+  // 槽位的状态
+  enum : unsigned char {
+    cq_slot_empty = 0,   // 尚未被使用
+    cq_slot_writing = 1, // 生产者已占用，正在构造元素
+    cq_slot_ready = 2,   // 元素已构造完成，可以出队
+    cq_slot_taken = 3    // 被消费者作废，生产者需另寻槽位
+  };
+
+  struct slot {
+    std::atomic<unsigned char> state;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T *value_ptr() { return reinterpret_cast<T *>(storage); }
+  };
+
+  struct segment {
+    alignas(64) std::atomic<size_type> enq_index; // 下一个可写的槽位
+    alignas(64) std::atomic<size_type> deq_index; // 下一个可读的槽位
+    alignas(64) std::atomic<segment *> next;      // 队列中的下一个段
+    segment *free_next; // 空闲链表/待回收链表中的下一个段
+    slot slots[segment_size];
+
+    segment() : enq_index(0), deq_index(0), next(nullptr), free_next(nullptr) {
+      for (size_type i = 0; i < segment_size; ++i) {
+        slots[i].state.store(cq_slot_empty, std::memory_order_relaxed);
+      }
+    }
+
+    // 回收前重置，调用时该段已不被任何线程引用
+    void reset() {
+      for (size_type i = 0; i < segment_size; ++i) {
+        slots[i].state.store(cq_slot_empty, std::memory_order_relaxed);
+      }
+      enq_index.store(0, std::memory_order_relaxed);
+      deq_index.store(0, std::memory_order_relaxed);
+      next.store(nullptr, std::memory_order_relaxed);
+      free_next = nullptr;
+    }
+  };
+
+  struct hazard_record {
+    alignas(64) std::atomic<bool> in_use;
+    std::atomic<segment *> ptr;
+    hazard_record *next; // 追加到链表后不再改变
+
+    hazard_record() : in_use(true), ptr(nullptr), next(nullptr) {}
+  };
+
+  // hazard pointer 的守卫，构造时占用一个 hazard_record，析构时释放
+  class hazard_guard {
+  public:
+    explicit hazard_guard(concurrent_queue &q)
+        : queue_(q), slot_(q.acquire_hazard()) {}
+    ~hazard_guard() { queue_.release_hazard(slot_); }
+
+    // 读取 src 并发布为 hazard，直到读取值稳定为止
+    segment *protect(const std::atomic<segment *> &src) {
+      segment *p = src.load();
+      while (true) {
+        slot_->ptr.store(p);
+        segment *q = src.load();
+        if (q == p)
+          return p;
+        p = q;
+      }
+    }
+
+  private:
+    concurrent_queue &queue_;
+    hazard_record *slot_;
+
+    hazard_guard(const hazard_guard &) = delete;
+    hazard_guard &operator=(const hazard_guard &) = delete;
+  };
+
+private:
+  alignas(64) std::atomic<segment *> head_; // 出队端所在的段
+  alignas(64) std::atomic<segment *> tail_; // 入队端所在的段
+  alignas(64) std::atomic<segment *> free_list_; // 可复用的空闲段
+  std::atomic<segment *> retired_;               // 等待回收的段
+  std::atomic<size_type> retired_count_;
+  std::atomic<hazard_record *> hazards_;     // hazard pointer 记录的链表
+  std::atomic<hazard_record *> hazard_hint_; // 最近释放的记录
+
+public:
+  // 构造、析构函数
+  concurrent_queue()
+      : free_list_(nullptr), retired_(nullptr), hazards_(nullptr),
+        hazard_hint_(nullptr) {
+    retired_count_.store(0, std::memory_order_relaxed);
+    segment *s = new segment();
+    head_.store(s, std::memory_order_relaxed);
+    tail_.store(s, std::memory_order_relaxed);
+  }
+
+  // 预先分配 n 个空闲段
+  explicit concurrent_queue(size_type n) : concurrent_queue() {
+    reserve_segments(n);
+  }
+
+  ~concurrent_queue();
+
+  concurrent_queue(const concurrent_queue &) = delete;
+  concurrent_queue &operator=(const concurrent_queue &) = delete;
+
+public:
+  // 入队
+  void enqueue(const value_type &value) { emplace(value); }
+  void enqueue(value_type &&value) { emplace(mystl::move(value)); }
+  void push(const value_type &value) { emplace(value); }
+  void push(value_type &&value) { emplace(mystl::move(value)); }
+
+  template <class... Args> void emplace(Args &&...args);
+
+  // 出队，队列为空时返回 false
+  // 若向 value 移动赋值时抛出异常，该元素已被取走，会被析构丢弃，异常继续传出
+  bool try_dequeue(value_type &value);
+  bool try_pop(value_type &value) { return try_dequeue(value); }
+
+  // 并发情况下的结果仅供参考
+  bool empty() const noexcept;
+
+  // 预先分配 n 个空闲段，避免之后入队时分配内存
+  void reserve_segments(size_type n);
+
+private:
+  // helper functions
+  hazard_record *acquire_hazard();
+  void release_hazard(hazard_record *h);
+
+  segment *new_segment();
+  void push_free(segment *first, segment *last);
+  void retire(segment *s);
+  void reclaim();
+  bool is_hazard(segment *s) const;
+
+  static void destroy_values(segment *s);
+  static void delete_chain(segment *s);
+};
+
+/*****************************************************************************************/
+
+// 析构函数，调用时不应再有其他线程访问该队列
+template <class T> concurrent_queue<T>::~concurrent_queue() {
+  segment *s = head_.load(std::memory_order_relaxed);
+  while (s != nullptr) {
+    segment *next = s->next.load(std::memory_order_relaxed);
+    destroy_values(s);
+    delete s;
+    s = next;
+  }
+  delete_chain(free_list_.load(std::memory_order_relaxed));
+  delete_chain(retired_.load(std::memory_order_relaxed));
+  hazard_record *h = hazards_.load(std::memory_order_relaxed);
+  while (h != nullptr) {
+    hazard_record *next = h->next;
+    delete h;
+    h = next;
+  }
+}
+
+// 在队尾就地构造元素
+template <class T>
+template <class... Args>
+void concurrent_queue<T>::emplace(Args &&...args) {
+  hazard_guard guard(*this);
+  while (true) {
+    segment *ltail = guard.protect(tail_);
+    const size_type idx = ltail->enq_index.fetch_add(1);
+    if (idx < segment_size) {
+      slot &sl = ltail->slots[idx];
+      unsigned char expected = cq_slot_empty;
+      if (sl.state.compare_exchange_strong(expected, cq_slot_writing,
+                                           std::memory_order_acquire)) {
+        try {
+          mystl::construct(sl.value_ptr(), mystl::forward<Args>(args)...);
+        } catch (...) {
+          // 构造失败，作废该槽位以免消费者一直等待
+          sl.state.store(cq_slot_taken, std::memory_order_release);
+          throw;
+        }
+        sl.state.store(cq_slot_ready, std::memory_order_release);
+        return;
+      }
+      // 槽位已被消费者作废，换下一个
+      continue;
+    }
+    // 当前段已写满，追加新段或帮助推进 tail_
+    segment *lnext = ltail->next.load();
+    if (lnext != nullptr) {
+      tail_.compare_exchange_strong(ltail, lnext);
+      continue;
+    }
+    // 追加一个空段后重新争抢槽位，参数只会被使用一次
+    segment *s = new_segment();
+    segment *expected = nullptr;
+    if (ltail->next.compare_exchange_strong(expected, s)) {
+      tail_.compare_exchange_strong(ltail, s);
+    } else {
+      push_free(s, s); // 其他线程已追加了新段
+    }
+  }
+}
+
+// 从队头取出元素
+template <class T> bool concurrent_queue<T>::try_dequeue(value_type &value) {
+  hazard_guard guard(*this);
+  while (true) {
+    segment *lhead = guard.protect(head_);
+    if (lhead->deq_index.load() >= lhead->enq_index.load() &&
+        lhead->next.load() == nullptr) {
+      return false;
+    }
+    const size_type idx = lhead->deq_index.fetch_add(1);
+    if (idx < segment_size) {
+      slot &sl = lhead->slots[idx];
+      unsigned char state = cq_slot_empty;
+      // 生产者还未占用该槽位，将其作废
+      if (sl.state.compare_exchange_strong(state, cq_slot_taken,
+                                           std::memory_order_acquire)) {
+        continue;
+      }
+      while (state == cq_slot_writing) {
+        std::this_thread::yield();
+        state = sl.state.load(std::memory_order_acquire);
+      }
+      if (state == cq_slot_taken) {
+        continue; // 生产者构造失败
+      }
+      // 槽位已被本线程独占，其他消费者不会再读到它，赋值失败也只能析构掉
+      try {
+        value = mystl::move(*sl.value_ptr());
+      } catch (...) {
+        mystl::destroy(sl.value_ptr());
+        throw;
+      }
+      mystl::destroy(sl.value_ptr());
+      return true;
+    }
+    // 当前段已读完，转到下一个段
+    segment *lnext = lhead->next.load();
+    if (lnext == nullptr) {
+      return false;
+    }
+    // 保证 tail_ 不落后于 head_，否则被摘下的段仍可能被生产者访问
+    segment *ltail = lhead;
+    tail_.compare_exchange_strong(ltail, lnext);
+    segment *expected = lhead;
+    if (head_.compare_exchange_strong(expected, lnext)) {
+      retire(lhead);
+    }
+  }
+}
+
+template <class T> bool concurrent_queue<T>::empty() const noexcept {
+  segment *lhead = head_.load();
+  return lhead->deq_index.load() >= lhead->enq_index.load() &&
+         lhead->next.load() == nullptr;
+}
+
+template <class T> void concurrent_queue<T>::reserve_segments(size_type n) {
+  for (; n > 0; --n) {
+    segment *s = new segment();
+    push_free(s, s);
+  }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 占用一个空闲的 hazard_record，先尝试最近释放的记录，再遍历链表，
+// 都在使用中时追加一个新记录
+template <class T>
+typename concurrent_queue<T>::hazard_record *
+concurrent_queue<T>::acquire_hazard() {
+  hazard_record *h = hazard_hint_.load(std::memory_order_acquire);
+  if (h != nullptr && !h->in_use.load(std::memory_order_relaxed) &&
+      !h->in_use.exchange(true, std::memory_order_acquire)) {
+    return h;
+  }
+  for (h = hazards_.load(std::memory_order_acquire); h != nullptr;
+       h = h->next) {
+    if (!h->in_use.load(std::memory_order_relaxed) &&
+        !h->in_use.exchange(true, std::memory_order_acquire)) {
+      return h;
+    }
+  }
+  h = new hazard_record();
+  hazard_record *old = hazards_.load(std::memory_order_relaxed);
+  do {
+    h->next = old;
+  } while (!hazards_.compare_exchange_weak(old, h, std::memory_order_release,
+                                           std::memory_order_relaxed));
+  return h;
+}
+
+template <class T>
+void concurrent_queue<T>::release_hazard(hazard_record *h) {
+  h->ptr.store(nullptr, std::memory_order_release);
+  h->in_use.store(false, std::memory_order_release);
+  hazard_hint_.store(h, std::memory_order_release);
+}
+
+// 优先从空闲链表取段，空闲链表为空时才分配
+// 整体摘下空闲链表再把剩余部分放回，从而避免 ABA 问题
+template <class T>
+typename concurrent_queue<T>::segment *concurrent_queue<T>::new_segment() {
+  segment *s = free_list_.exchange(nullptr, std::memory_order_acquire);
+  if (s == nullptr) {
+    return new segment();
+  }
+  segment *rest = s->free_next;
+  if (rest != nullptr) {
+    segment *last = rest;
+    while (last->free_next != nullptr) {
+      last = last->free_next;
+    }
+    push_free(rest, last);
+  }
+  s->free_next = nullptr;
+  return s;
+}
+
+// 将 [first, last] 所连接的一串段放入空闲链表
+template <class T>
+void concurrent_queue<T>::push_free(segment *first, segment *last) {
+  segment *old = free_list_.load(std::memory_order_relaxed);
+  do {
+    last->free_next = old;
+  } while (!free_list_.compare_exchange_weak(
+      old, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// 将已从队列摘下的段放入待回收链表，积累到一定数量后统一回收
+template <class T> void concurrent_queue<T>::retire(segment *s) {
+  segment *old = retired_.load(std::memory_order_relaxed);
+  do {
+    s->free_next = old;
+  } while (!retired_.compare_exchange_weak(old, s, std::memory_order_release,
+                                           std::memory_order_relaxed));
+  if (retired_count_.fetch_add(1) + 1 >= 2) {
+    reclaim();
+  }
+}
+
+// 检查待回收链表，没有被任何 hazard pointer 引用的段重置后放入空闲链表
+template <class T> void concurrent_queue<T>::reclaim() {
+  retired_count_.store(0);
+  segment *s = retired_.exchange(nullptr, std::memory_order_acquire);
+  segment *keep = nullptr;
+  size_type kept = 0;
+  while (s != nullptr) {
+    segment *next = s->free_next;
+    if (is_hazard(s)) {
+      s->free_next = keep;
+      keep = s;
+      ++kept;
+    } else {
+      s->reset();
+      push_free(s, s);
+    }
+    s = next;
+  }
+  // 仍被引用的段放回待回收链表
+  while (keep != nullptr) {
+    segment *next = keep->free_next;
+    segment *old = retired_.load(std::memory_order_relaxed);
+    do {
+      keep->free_next = old;
+    } while (!retired_.compare_exchange_weak(old, keep));
+    keep = next;
+  }
+  retired_count_.fetch_add(kept);
+}
+
+template <class T> bool concurrent_queue<T>::is_hazard(segment *s) const {
+  for (hazard_record *h = hazards_.load(std::memory_order_acquire);
+       h != nullptr; h = h->next) {
+    if (h->ptr.load() == s) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 析构段中尚未出队的元素
+template <class T> void concurrent_queue<T>::destroy_values(segment *s) {
+  const size_type n = mystl::min(s->enq_index.load(), segment_size);
+  for (size_type i = s->deq_index.load(); i < n; ++i) {
+    if (s->slots[i].state.load() == cq_slot_ready) {
+      mystl::destroy(s->slots[i].value_ptr());
+    }
+  }
+}
+
+// 释放以 free_next 连接的一串段
+template <class T> void concurrent_queue<T>::delete_chain(segment *s) {
+  while (s != nullptr) {
+    segment *next = s->free_next;
+    delete s;
+    s = next;
+  }
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_CONCURRENT_QUEUE_H_
@@ -30,6 +30,10 @@ template <class Ty> void destroy_one(Ty *pointer, std::false_type) {
   }
 }
 
+template <class Ty> void destroy(Ty *pointer) {
+  destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+}
+
 template <class ForwardIter>
 void destroy_cat(ForwardIter, ForwardIter, std::true_type) {}
 
@@ -39,10 +43,6 @@ void destroy_cat(ForwardIter first, ForwardIter last, std::false_type) {
     destroy(&*first);
 }
 
-template <class Ty> void destroy(Ty *pointer) {
-  destroy_one(pointer, std::is_trivially_destructible<Ty>{});
-}
-
 template <class ForwardIter> void destroy(ForwardIter first, ForwardIter last) {
   destroy_cat(first, last,
               std::is_trivially_destructible<
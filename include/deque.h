@@ -91,7 +91,8 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T> {
   deque_iterator(const const_iterator &rhs)
       : cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {}
 
-  self &operator=(const iterator &rhs) {
+  // 从 iterator 赋值给 const_iterator 时先经过上面的转换构造
+  self &operator=(const self &rhs) {
     if (this != &rhs) {
       cur = rhs.cur;
       first = rhs.first;
@@ -184,6 +185,32 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T> {
   bool operator>=(const self &rhs) const { return !(*this < rhs); }
 };
 
+// deque_iterator 是分段迭代器，每个缓冲区为一段，段内迭代器为指针，
+// copy、fill、find 等算法逐个缓冲区处理，不必逐个元素经过 operator++
+template <class T, class Ref, class Ptr>
+struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr>> {
+  typedef m_true_type is_segmented;
+  typedef deque_iterator<T, Ref, Ptr> iterator;
+  typedef typename iterator::map_pointer segment_iterator;
+  typedef Ptr local_iterator;
+
+  static segment_iterator segment(const iterator &it) { return it.node; }
+  static local_iterator local(const iterator &it) { return it.cur; }
+  static local_iterator begin(segment_iterator seg) { return *seg; }
+  static local_iterator end(segment_iterator seg) {
+    return *seg + iterator::buffer_size;
+  }
+
+  // 与 operator++ 一致，位于缓冲区尾部时转到下一个缓冲区的头部
+  static iterator compose(segment_iterator seg, local_iterator local) {
+    if (local == end(seg)) {
+      ++seg;
+      local = begin(seg);
+    }
+    return iterator(const_cast<T *>(local), seg);
+  }
+};
+
 // 模板类 deque
 // 模板参数代表数据类型
 template <class T> class deque {
@@ -514,7 +541,7 @@ void deque<T>::emplace_front(Args &&...args) {
 template <class T>
 template <class... Args>
 void deque<T>::emplace_back(Args &&...args) {
-  if (end_.cur == end_.last) {
+  if (end_.cur == end_.last - 1) {
     require_capacity(1, false);
   }
   data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
@@ -551,7 +578,7 @@ template <class T> void deque<T>::push_front(const value_type &value) {
 
 // 在尾部插入元素
 template <class T> void deque<T>::push_back(const value_type &value) {
-  if (end_.cur == end_.last) {
+  if (end_.cur == end_.last - 1) {
     require_capacity(1, false);
   }
   data_allocator::construct(end_.cur, value);
@@ -667,12 +694,14 @@ typename deque<T>::iterator deque<T>::erase(iterator first, iterator last) {
     if (elems_before < ((size() - len) / 2)) {
       mystl::copy_backward(begin_, first, last);
       auto new_begin = begin_ + len;
-      data_allocator::destroy(begin_.cur, new_begin.cur);
+      mystl::destroy(begin_, new_begin);
+      destroy_buffer(begin_.node, new_begin.node - 1);
       begin_ = new_begin;
     } else {
       mystl::copy(last, end_, first);
       auto new_end = end_ - len;
-      data_allocator::destroy(new_end.cur, end_.cur);
+      mystl::destroy(new_end, end_);
+      destroy_buffer(new_end.node + 1, end_.node);
       end_ = new_end;
     }
     return begin_ + elems_before;
@@ -694,7 +723,8 @@ template <class T> void deque<T>::clear() {
     } else {
       mystl::destroy(begin_.cur, end_.cur);
     }
-    // 注意: clear不释放内存，只析构元素
+    // 只保留头部的一个缓冲区
+    destroy_buffer(begin_.node + 1, end_.node);
     end_ = begin_;
   }
 }
@@ -725,16 +755,30 @@ typename deque<T>::map_pointer deque<T>::create_map(size_type size) {
 // create_buffer 函数
 template <class T>
 void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish) {
-  map_pointer cur;
+  // require_capacity 可能多分配一个缓冲区，留在 [begin_, end_) 之外，
+  // 之后再次扩充时沿用它。这样已有的缓冲区只会紧挨着 begin_ 或 end_，
+  // 在区间中要么全在新分配的之前，要么全在之后，所以新分配的缓冲区是连续的，
+  // 异常时只释放 [created, cur)
+  map_pointer created = nullptr;
+  map_pointer cur = nstart;
+  bool reused_after = false; // 新分配的缓冲区之后是否出现了已有的缓冲区
   try {
-    for (cur = nstart; cur <= nfinish; ++cur) {
-      *cur = data_allocator::allocate(buffer_size);
+    for (; cur <= nfinish; ++cur) {
+      if (*cur == nullptr) {
+        MYSTL_DEBUG(!reused_after);
+        *cur = data_allocator::allocate(buffer_size);
+        if (created == nullptr) {
+          created = cur;
+        }
+      } else if (created != nullptr) {
+        reused_after = true;
+      }
     }
+    (void)reused_after;
   } catch (...) {
-    while (cur != nstart) {
-      --cur;
-      data_allocator::deallocate(*cur, buffer_size);
-      *cur = nullptr;
+    for (; created != nullptr && created != cur; ++created) {
+      data_allocator::deallocate(*created, buffer_size);
+      *created = nullptr;
     }
     throw;
   }
@@ -753,12 +797,15 @@ void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
 
 // destroy_elements_and_buffers 函数
 template <class T> void deque<T>::destroy_elements_and_buffers() {
+  if (map_ == nullptr) {
+    return;
+  }
   if (!empty()) {
     // 析构所有元素
     clear();
   }
-  // 释放所有缓冲区
-  destroy_buffer(begin_.node, end_.node);
+  // 释放所有缓冲区，包括 [begin_, end_) 之外预先分配的
+  destroy_buffer(map_, map_ + map_size_ - 1);
 }
 
 // map_init函数
@@ -923,8 +970,13 @@ void deque<T>::fill_insert(iterator position, size_type n,
         mystl::copy(begin_n, position, old_begin);
         mystl::fill(position - n, position, value_copy);
       } else {
-        mystl::uninitialized_fill((mystl::copy(begin_, position, new_begin)),
-                                  begin_, value_copy);
+        auto mid = mystl::uninitialized_copy(begin_, position, new_begin);
+        try {
+          mystl::uninitialized_fill(mid, begin_, value_copy);
+        } catch (...) {
+          mystl::destroy(new_begin, mid);
+          throw;
+        }
         begin_ = new_begin;
         mystl::fill(old_begin, position, value_copy);
       }
@@ -950,7 +1002,12 @@ void deque<T>::fill_insert(iterator position, size_type n,
         mystl::fill(position, position + n, value_copy);
       } else {
         mystl::uninitialized_fill(end_, position + n, value_copy);
-        mystl::uninitialized_copy(position, end_, position + n);
+        try {
+          mystl::uninitialized_copy(position, end_, position + n);
+        } catch (...) {
+          mystl::destroy(end_, position + n);
+          throw;
+        }
         end_ = new_end;
         mystl::fill(position, old_end, value_copy);
       }
@@ -1008,7 +1065,7 @@ void deque<T>::copy_insert(iterator position, FIter first, FIter last,
       if (elems_after > n) {
         auto end_n = end_ - n;
         mystl::uninitialized_copy(end_n, end_, end_);
-        end_ - new_end;
+        end_ = new_end;
         mystl::copy_backward(position, end_n, old_end);
         mystl::copy(first, last, position);
       } else {
@@ -1071,7 +1128,7 @@ void deque<T>::insert_dispatch(iterator position, FIter first, FIter last,
       }
       throw;
     }
-  } else if (position.cur == end_.node) {
+  } else if (position.cur == end_.cur) {
     require_capacity(n, false);
     auto new_end = end_ + n;
     try {
@@ -1098,12 +1155,14 @@ template <class T> void deque<T>::require_capacity(size_type n, bool front) {
       return;
     }
     create_buffer(begin_.node - need_buffer, begin_.node - 1);
-  } else if (!front && (static_cast<size_type>(end_.last - end_.cur) < n)) {
+  } else if (!front &&
+             (static_cast<size_type>(end_.last - end_.cur - 1) < n)) {
+    // end_ 不能停在缓冲区的尾部，所以尾部缓冲区只剩 last - cur - 1 个位置
     const size_type need_buffer =
-        (n - (end_.last - end_.cur)) / buffer_size + 1;
+        (n - (end_.last - end_.cur - 1)) / buffer_size + 1;
     if (need_buffer >
-        static_cast<size_type>(map_ + map_size_) - end_.node - 1) {
-      reallocate_map_at_front(need_buffer);
+        static_cast<size_type>(map_ + map_size_ - end_.node - 1)) {
+      reallocate_map_at_back(need_buffer);
       return;
     }
     create_buffer(end_.node + 1, end_.node + need_buffer);
@@ -1128,9 +1187,15 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer) {
     *dst = *src;
   }
 
-  create_buffer(new_nstart, new_mid - 1);
+  try {
+    create_buffer(new_nstart, new_mid - 1);
+  } catch (...) {
+    map_allocator::deallocate(new_map, new_map_size);
+    throw;
+  }
 
-  // 更新 Map 指针和大小
+  // 更新 Map 指针和大小，旧 map 中 [begin_, end_) 之外的缓冲区不再使用
+  shrink_to_fit();
   map_allocator::deallocate(map_, map_size_);
   map_ = new_map;
   map_size_ = new_map_size;
@@ -1157,9 +1222,15 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer) {
     *dst = *src;
   }
 
-  create_buffer(new_mid, new_nfinish);
+  try {
+    create_buffer(new_mid, new_nfinish);
+  } catch (...) {
+    map_allocator::deallocate(new_map, new_map_size);
+    throw;
+  }
 
-  // 更新map指针和大小
+  // 更新map指针和大小，旧 map 中 [begin_, end_) 之外的缓冲区不再使用
+  shrink_to_fit();
   map_allocator::deallocate(map_, map_size_);
   map_ = new_map;
   map_size_ = new_map_size;
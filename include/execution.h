@@ -0,0 +1,106 @@
+#ifndef MYTINYSTL_EXECUTION_H_
+#define MYTINYSTL_EXECUTION_H_
+
+// 这个头文件定义了并行算法使用的执行策略
+// seq      : 顺序执行
+// unseq    : 在当前线程执行，允许向量化
+// par      : 允许在多个线程上并行执行
+// par_unseq: 允许多线程并行执行，并在每个线程内向量化
+
+#include <type_traits>
+
+#include "type_traits.h"
+
+namespace mystl {
+namespace execution {
+
+struct sequenced_policy {};
+struct unsequenced_policy {};
+struct parallel_policy {};
+struct parallel_unsequenced_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr unsequenced_policy unseq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+// is_execution_policy
+// 判断一个类型是否为执行策略
+template <class T> struct is_execution_policy : public m_false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : public m_true_type {};
+
+template <>
+struct is_execution_policy<execution::unsequenced_policy>
+    : public m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : public m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy>
+    : public m_true_type {};
+
+// is_parallel_policy
+// 执行策略是否允许多线程执行
+template <class T> struct is_parallel_policy : public m_false_type {};
+
+template <>
+struct is_parallel_policy<execution::parallel_policy> : public m_true_type {};
+
+template <>
+struct is_parallel_policy<execution::parallel_unsequenced_policy>
+    : public m_true_type {};
+
+// is_unsequenced_policy
+// 执行策略是否允许向量化
+template <class T> struct is_unsequenced_policy : public m_false_type {};
+
+template <>
+struct is_unsequenced_policy<execution::unsequenced_policy>
+    : public m_true_type {};
+
+template <>
+struct is_unsequenced_policy<execution::parallel_unsequenced_policy>
+    : public m_true_type {};
+
+// 当 ExecutionPolicy 为执行策略时，enable_if_execution_policy 为 T
+template <class ExecutionPolicy, class T>
+using enable_if_execution_policy = typename std::enable_if<
+    is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value,
+    T>::type;
+
+// 以下两个函数把执行策略转换为 std::true_type / std::false_type，用于分派
+template <class ExecutionPolicy>
+std::integral_constant<
+    bool, is_parallel_policy<typename std::decay<ExecutionPolicy>::type>::value>
+policy_parallel(const ExecutionPolicy &) {
+  return {};
+}
+
+template <class ExecutionPolicy>
+std::integral_constant<
+    bool,
+    is_unsequenced_policy<typename std::decay<ExecutionPolicy>::type>::value>
+policy_unsequenced(const ExecutionPolicy &) {
+  return {};
+}
+
+// MYSTL_PRAGMA_SIMD
+// 提示编译器循环的各次迭代之间没有依赖，可以向量化
+#if defined(__clang__)
+#define MYSTL_PRAGMA_SIMD                                                      \
+  _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define MYSTL_PRAGMA_SIMD _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define MYSTL_PRAGMA_SIMD __pragma(loop(ivdep))
+#else
+#define MYSTL_PRAGMA_SIMD
+#endif
+
+} // namespace mystl
+#endif // !MYTINYSTL_EXECUTION_H_
@@ -0,0 +1,460 @@
+#ifndef MYTINYSTL_EXTERNAL_SORT_H_
+#define MYTINYSTL_EXTERNAL_SORT_H_
+
+// 这个头文件包含外部排序 external_sort，用于对放不进内存的定长记录文件排序
+
+// notes:
+//
+// 输入文件由连续存放的 T 组成，T 必须可平凡拷贝。排序分两步：
+// 1. 生成有序段：每次读入内存预算能容纳的记录，用 mystl::sort 排好后
+//    一次写入一个临时文件。输入只有一段时直接写到输出文件
+// 2. 合并：每个有序段配两个读缓冲区，一个供败者树合并，另一个由线程池
+//    在后台预读下一块；输出同样用两个缓冲区交替写出。内存只够同时合并
+//    fan_in 段时，先把每 fan_in 段合并为一段，重复直到可以一趟合并完
+// 读写都以较大的块进行，文件以无缓冲方式打开，避免 stdio 再拷贝一次
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "algo.h"
+#include "exceptdef.h"
+#include "functional.h"
+#include "memory.h"
+#include "multiway_merge.h"
+#include "random.h"
+#include "thread_pool.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+// 合并时每个读写缓冲区的最小字节数，内存不足时减少一趟合并的段数
+constexpr size_t kExternalMinBlock = size_t(1) << 16;
+// 一趟合并最多同时打开的段数
+constexpr size_t kExternalMaxFanIn = 512;
+
+struct external_sort_options {
+  size_t memory_budget = size_t(256) << 20; // 排序使用的内存上限，单位为字节
+  const char *temp_dir = nullptr; // 临时文件所在目录，为 nullptr 时使用 tmpfile
+};
+
+/*****************************************************************************************/
+// external_file
+// 对 FILE* 的简单包装，负责打开、整块读写与关闭，出错时抛出 runtime_error。
+// 在指定目录中创建的临时文件在关闭时删除
+/*****************************************************************************************/
+class external_file {
+private:
+  FILE *fp_;
+  mystl::vector<char> path_; // 需要在关闭时删除的文件名，为空时不删除
+
+public:
+  external_file() noexcept : fp_(nullptr) {}
+  external_file(external_file &&rhs) noexcept
+      : fp_(rhs.fp_), path_(mystl::move(rhs.path_)) {
+    rhs.fp_ = nullptr;
+  }
+  external_file &operator=(external_file &&rhs) noexcept {
+    if (this != &rhs) {
+      close();
+      fp_ = rhs.fp_;
+      path_ = mystl::move(rhs.path_);
+      rhs.fp_ = nullptr;
+    }
+    return *this;
+  }
+  ~external_file() { close(); }
+
+  external_file(const external_file &) = delete;
+  external_file &operator=(const external_file &) = delete;
+
+  void open(const char *path, const char *mode) {
+    close();
+    fp_ = std::fopen(path, mode);
+    THROW_RUNTIME_ERROR(fp_ == nullptr, "external_sort: cannot open file");
+    std::setvbuf(fp_, nullptr, _IONBF, 0);
+  }
+
+  // 创建一个可读写的临时文件
+  void open_temp(const char *dir) {
+    close();
+    if (dir == nullptr) {
+      fp_ = std::tmpfile();
+      THROW_RUNTIME_ERROR(fp_ == nullptr,
+                          "external_sort: cannot create temporary file");
+      std::setvbuf(fp_, nullptr, _IONBF, 0);
+      return;
+    }
+    const size_t len = std::strlen(dir) + 40;
+    path_.reserve(len);
+    for (size_t i = 0; i < len; ++i) {
+      path_.push_back('\0');
+    }
+    // 以随机数命名，"x" 保证不会打开已存在的文件，重名时换一个名字重试
+    for (int attempt = 0; attempt < 16 && fp_ == nullptr; ++attempt) {
+      std::snprintf(path_.data(), len, "%s/mystl-sort-%016llx.tmp", dir,
+                    static_cast<unsigned long long>(
+                        mystl::thread_random_engine()()));
+      fp_ = std::fopen(path_.data(), "w+bx");
+    }
+    if (fp_ == nullptr) {
+      path_.clear();
+      THROW_RUNTIME_ERROR(true, "external_sort: cannot create temporary file");
+    }
+    std::setvbuf(fp_, nullptr, _IONBF, 0);
+  }
+
+  void close() noexcept {
+    if (fp_ != nullptr) {
+      std::fclose(fp_);
+      fp_ = nullptr;
+    }
+    if (!path_.empty()) {
+      std::remove(path_.data());
+      path_.clear();
+    }
+  }
+
+  void write(const void *data, size_t bytes) {
+    THROW_RUNTIME_ERROR(std::fwrite(data, 1, bytes, fp_) != bytes,
+                        "external_sort: write failed");
+  }
+
+  // 读入最多 bytes 个字节，返回实际读入的字节数，只在文件结束时少于 bytes
+  size_t read(void *data, size_t bytes) {
+    const size_t got = std::fread(data, 1, bytes, fp_);
+    THROW_RUNTIME_ERROR(got != bytes && std::ferror(fp_),
+                        "external_sort: read failed");
+    return got;
+  }
+
+  bool at_end() {
+    const int c = std::fgetc(fp_);
+    THROW_RUNTIME_ERROR(c == EOF && std::ferror(fp_),
+                        "external_sort: read failed");
+    if (c == EOF) {
+      return true;
+    }
+    std::ungetc(c, fp_);
+    return false;
+  }
+
+  void rewind() {
+    THROW_RUNTIME_ERROR(std::fseek(fp_, 0, SEEK_SET) != 0,
+                        "external_sort: seek failed");
+  }
+
+  void flush() {
+    THROW_RUNTIME_ERROR(std::fflush(fp_) != 0, "external_sort: write failed");
+  }
+};
+
+/*****************************************************************************************/
+// external_io_task
+// 在线程池中执行的一次整块读或写
+/*****************************************************************************************/
+struct external_io_task : public pool_task {
+  external_file *file;
+  void *data;
+  size_t bytes;
+  bool reading;
+
+  external_io_task()
+      : pool_task(&external_io_task::invoke), file(nullptr), data(nullptr),
+        bytes(0), reading(true) {}
+
+  static void invoke(pool_task *t) {
+    auto *io = static_cast<external_io_task *>(t);
+    if (io->reading) {
+      io->bytes = io->file->read(io->data, io->bytes);
+    } else {
+      io->file->write(io->data, io->bytes);
+    }
+  }
+};
+
+// 管理至多一个正在后台执行的读写任务，析构时等待它完成，
+// 保证任务不会在缓冲区释放之后还在使用它
+class external_io {
+private:
+  external_io_task *task_;
+  bool pending_;
+
+public:
+  external_io() : task_(new external_io_task), pending_(false) {}
+  external_io(external_io &&rhs) noexcept
+      : task_(rhs.task_), pending_(rhs.pending_) {
+    rhs.task_ = nullptr;
+    rhs.pending_ = false;
+  }
+  ~external_io() {
+    if (pending_) {
+      mystl::default_thread_pool().wait(task_);
+    }
+    delete task_;
+  }
+
+  external_io(const external_io &) = delete;
+  external_io &operator=(const external_io &) = delete;
+  external_io &operator=(external_io &&) = delete;
+
+  bool pending() const noexcept { return pending_; }
+
+  void start(external_file *file, void *data, size_t bytes, bool reading) {
+    MYSTL_DEBUG(!pending_);
+    task_->file = file;
+    task_->data = data;
+    task_->bytes = bytes;
+    task_->reading = reading;
+    task_->done.store(false, std::memory_order_relaxed);
+    task_->error = nullptr;
+    mystl::default_thread_pool().spawn(task_);
+    pending_ = true;
+  }
+
+  // 等待任务完成，返回读入或写出的字节数
+  size_t finish() {
+    MYSTL_DEBUG(pending_);
+    mystl::default_thread_pool().wait(task_);
+    pending_ = false;
+    task_->rethrow_if_error();
+    return task_->bytes;
+  }
+};
+
+/*****************************************************************************************/
+// external_reader
+// 顺序读出一个有序段，当前缓冲区用完时换到后台预读好的另一个缓冲区
+/*****************************************************************************************/
+template <class T> class external_reader {
+private:
+  external_file *file_;
+  T *front_; // 正在读取的缓冲区
+  T *back_;  // 后台预读的缓冲区
+  size_t block_;
+  const T *cur_;
+  const T *end_;
+  external_io io_;
+
+public:
+  // buf 至少能容纳 2 * block 条记录
+  external_reader(external_file *file, T *buf, size_t block)
+      : file_(file), front_(buf), back_(buf + block), block_(block),
+        cur_(buf), end_(buf) {
+    file_->rewind();
+    end_ = front_ + file_->read(front_, block_ * sizeof(T)) / sizeof(T);
+    if (static_cast<size_t>(end_ - front_) == block_) {
+      io_.start(file_, back_, block_ * sizeof(T), true);
+    }
+  }
+
+  external_reader(external_reader &&) = default;
+
+  bool empty() const noexcept { return cur_ == end_; }
+  const T *head() const noexcept { return cur_; }
+
+  void next() {
+    if (++cur_ == end_ && io_.pending()) {
+      const size_t got = io_.finish() / sizeof(T);
+      mystl::swap(front_, back_);
+      cur_ = front_;
+      end_ = front_ + got;
+      if (got == block_) {
+        io_.start(file_, back_, block_ * sizeof(T), true);
+      }
+    }
+  }
+};
+
+/*****************************************************************************************/
+// external_writer
+// 把记录依次写入文件，写满一个缓冲区后交给线程池写出，同时填充另一个缓冲区
+/*****************************************************************************************/
+template <class T> class external_writer {
+private:
+  external_file *file_;
+  T *front_; // 正在填充的缓冲区
+  T *back_;  // 后台写出中的缓冲区
+  size_t block_;
+  size_t count_;
+  external_io io_;
+
+public:
+  // buf 至少能容纳 2 * block 条记录
+  external_writer(external_file *file, T *buf, size_t block)
+      : file_(file), front_(buf), back_(buf + block), block_(block),
+        count_(0) {}
+
+  void put(const T &value) {
+    front_[count_] = value;
+    if (++count_ == block_) {
+      flush_block();
+    }
+  }
+
+  // 写出剩余的记录并等待全部写完
+  void finish() {
+    if (count_ != 0) {
+      flush_block();
+    }
+    if (io_.pending()) {
+      io_.finish();
+    }
+    file_->flush();
+  }
+
+private:
+  void flush_block() {
+    if (io_.pending()) {
+      io_.finish();
+    }
+    io_.start(file_, front_, count_ * sizeof(T), false);
+    mystl::swap(front_, back_);
+    count_ = 0;
+  }
+};
+
+/*****************************************************************************************/
+// external_merge
+// 把 [first, last) 中的有序段合并写入 out，buf 至少能容纳
+// 2 * (段数 + 1) * block 条记录
+/*****************************************************************************************/
+template <class T, class Compared>
+void external_merge(external_file *first, external_file *last,
+                    external_file &out, T *buf, size_t block, Compared comp) {
+  mystl::vector<external_reader<T>> readers;
+  readers.reserve(static_cast<size_t>(last - first));
+  for (; first != last; ++first) {
+    readers.emplace_back(first, buf, block);
+    buf += 2 * block;
+  }
+  external_writer<T> writer(&out, buf, block);
+  // 未读完的段在 readers 中的下标，保持段的先后以保证稳定
+  mystl::vector<size_t> active;
+  for (size_t i = 0; i < readers.size(); ++i) {
+    if (!readers[i].empty()) {
+      active.push_back(i);
+    }
+  }
+  loser_tree<T, Compared> tree(active.size(), comp);
+  while (active.size() > 1) {
+    for (size_t i = 0; i < active.size(); ++i) {
+      tree.set(i, readers[active[i]].head());
+    }
+    tree.build(active.size());
+    while (true) {
+      auto &r = readers[active[tree.top()]];
+      writer.put(*r.head());
+      r.next();
+      if (r.empty())
+        break;
+      tree.replace_top(r.head());
+    }
+    // 去掉读完的段后重新建树
+    for (size_t i = tree.top() + 1; i < active.size(); ++i) {
+      active[i - 1] = active[i];
+    }
+    active.pop_back();
+  }
+  if (!active.empty()) {
+    for (auto &r = readers[active[0]]; !r.empty(); r.next()) {
+      writer.put(*r.head());
+    }
+  }
+  writer.finish();
+}
+
+/*****************************************************************************************/
+// external_sort
+// 对文件 input 中的 T 类型记录排序，结果写入文件 output，
+// input 与 output 可以是同一个文件
+/*****************************************************************************************/
+template <class T, class Compared>
+void external_sort(const char *input, const char *output, Compared comp,
+                   const external_sort_options &options =
+                       external_sort_options()) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "external_sort requires trivially copyable records");
+  const auto want = static_cast<ptrdiff_t>(options.memory_budget / sizeof(T));
+  auto buffer = mystl::get_temporary_buffer<T>(want < 2 ? 2 : want);
+  THROW_RUNTIME_ERROR(buffer.first == nullptr,
+                      "external_sort: cannot allocate buffer");
+  // 缓冲区中只存放可平凡拷贝的记录，无需构造与析构
+  struct buffer_guard {
+    T *p;
+    ~buffer_guard() { mystl::release_temporary_buffer(p); }
+  } guard{buffer.first};
+  T *const buf = buffer.first;
+  const size_t n = static_cast<size_t>(buffer.second);
+
+  // 生成有序段
+  mystl::vector<external_file> runs;
+  {
+    external_file in;
+    in.open(input, "rb");
+    while (true) {
+      const size_t bytes = in.read(buf, n * sizeof(T));
+      THROW_RUNTIME_ERROR(bytes % sizeof(T) != 0,
+                          "external_sort: truncated record in input");
+      const size_t count = bytes / sizeof(T);
+      if (count == 0)
+        break;
+      mystl::sort(buf, buf + count, comp);
+      if (runs.empty() && in.at_end()) {
+        // 只有一段，直接写到输出文件
+        in.close();
+        external_file out;
+        out.open(output, "wb");
+        out.write(buf, count * sizeof(T));
+        out.flush();
+        return;
+      }
+      runs.emplace_back();
+      runs.back().open_temp(options.temp_dir);
+      runs.back().write(buf, count * sizeof(T));
+    }
+  }
+
+  // 每段两个读缓冲区，输出两个写缓冲区，缓冲区不小于 kExternalMinBlock
+  const size_t min_block =
+      kExternalMinBlock / sizeof(T) == 0 ? 1 : kExternalMinBlock / sizeof(T);
+  size_t fan_in = n / (2 * min_block);
+  fan_in = fan_in < 3 ? 2 : fan_in - 1;
+  fan_in = fan_in < kExternalMaxFanIn ? fan_in : kExternalMaxFanIn;
+  // 多趟合并，直到剩下的段可以一趟合并到输出文件
+  while (runs.size() > fan_in) {
+    const size_t block = n / (2 * (fan_in + 1));
+    THROW_RUNTIME_ERROR(block == 0, "external_sort: memory budget too small");
+    mystl::vector<external_file> merged;
+    for (size_t i = 0; i < runs.size(); i += fan_in) {
+      const size_t m = runs.size() - i < fan_in ? runs.size() - i : fan_in;
+      merged.emplace_back();
+      merged.back().open_temp(options.temp_dir);
+      external_merge(runs.data() + i, runs.data() + i + m, merged.back(), buf,
+                     block, comp);
+      for (size_t j = i; j < i + m; ++j) {
+        runs[j].close();
+      }
+    }
+    runs.swap(merged);
+  }
+  external_file out;
+  out.open(output, "wb");
+  const size_t block = n / (2 * (runs.size() + 1));
+  THROW_RUNTIME_ERROR(block == 0, "external_sort: memory budget too small");
+  external_merge(runs.data(), runs.data() + runs.size(), out, buf, block,
+                 comp);
+}
+
+template <class T>
+void external_sort(const char *input, const char *output,
+                   const external_sort_options &options =
+                       external_sort_options()) {
+  mystl::external_sort<T>(input, output, mystl::less<T>(), options);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_EXTERNAL_SORT_H_
@@ -0,0 +1,168 @@
+#ifndef MYTINYSTL_EYTZINGER_H_
+#define MYTINYSTL_EYTZINGER_H_
+
+// 这个头文件包含一个模板类 eytzinger_array
+// eytzinger_array : 按广度优先顺序存放有序序列的只读查找表
+
+// notes:
+//
+// 第 k 个节点的左右子节点为 2k 和 2k + 1，查找路径上前几层的节点集中在
+// 数组的前部，且每个节点的后代在数组中连续存放，因此一次预取就可以把
+// 几层之后要访问的节点读入缓存。查找过程不含分支，只根据比较结果决定向左
+// 还是向右，结束后去掉最后一次向左之后的所有向右步骤即得到结果。
+// 批量查找时多个查找按层同步进行，可以同时等待多个缓存缺失。
+//
+// 查找返回指向表中元素的指针，没有满足条件的元素时返回 nullptr
+
+#include <bit>
+#include <cstddef>
+
+#include "functional.h"
+#include "iterator.h"
+#include "simd.h"
+#include "vector.h"
+
+namespace mystl {
+
+// 批量查找时同时进行的查找个数
+constexpr static size_t kEytzingerBatch = 16;
+
+template <class T, class Compared = mystl::less<T>> class eytzinger_array {
+public:
+  typedef T value_type;
+  typedef const T *const_pointer;
+  typedef const T &const_reference;
+  typedef size_t size_type;
+  typedef Compared value_compare;
+
+private:
+  // 一个缓存行中的元素个数，预取 k * kLineElements 即预取若干层之后的后代
+  static constexpr size_type kLineElements =
+      sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+  // data_[0] 不是树中的节点，只用于让越过叶子的查找读取合法的位置
+  mystl::vector<T> data_;
+  size_type size_;
+  Compared comp_;
+
+public:
+  eytzinger_array() : size_(0), comp_() {}
+
+  // [first, last) 必须已按 comp 排序
+  template <class ForwardIter>
+  eytzinger_array(ForwardIter first, ForwardIter last,
+                  const Compared &comp = Compared())
+      : size_(0), comp_(comp) {
+    assign(first, last);
+  }
+
+  template <class ForwardIter> void assign(ForwardIter first, ForwardIter last);
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  value_compare value_comp() const { return comp_; }
+
+  // 第一个不小于 key 的元素
+  template <class K> const_pointer lower_bound(const K &key) const {
+    size_type k = 1;
+    while (k <= size_) {
+      prefetch_descendants(k);
+      k = 2 * k + static_cast<size_type>(comp_(data_[k], key));
+    }
+    return decode(k);
+  }
+
+  template <class K> bool contains(const K &key) const {
+    const_pointer p = lower_bound(key);
+    return p != nullptr && !comp_(key, *p);
+  }
+
+  // 对 [first, last) 中的每个键查找第一个不小于它的元素，结果依次写入 result
+  template <class ForwardIter, class OutputIter>
+  OutputIter lower_bound(ForwardIter first, ForwardIter last,
+                         OutputIter result) const;
+
+private:
+  void prefetch_descendants(size_type k) const noexcept {
+    const size_type i = k * kLineElements;
+    mystl::simd_prefetch(data_.data() + (i < data_.size() ? i : 0));
+  }
+
+  // 去掉末尾连续的向右步骤和最后一次向左的步骤，回到答案所在的节点
+  const_pointer decode(size_type k) const noexcept {
+    k >>= std::countr_one(k) + 1;
+    return k == 0 ? nullptr : data_.data() + k;
+  }
+
+  template <class ForwardIter> void build(ForwardIter &it, size_type k);
+};
+
+/*****************************************************************************************/
+// helper function
+
+template <class T, class Compared>
+template <class ForwardIter>
+void eytzinger_array<T, Compared>::assign(ForwardIter first,
+                                          ForwardIter last) {
+  data_.clear();
+  size_ = 0;
+  if (first == last) {
+    return;
+  }
+  const auto n = static_cast<size_type>(mystl::distance(first, last));
+  data_.reserve(n + 1);
+  data_.emplace_back(*first);
+  for (auto it = first; it != last; ++it) {
+    data_.emplace_back(*it);
+  }
+  size_ = n;
+  build(first, 1);
+}
+
+// 按中序遍历的顺序把有序序列依次填入各个节点
+template <class T, class Compared>
+template <class ForwardIter>
+void eytzinger_array<T, Compared>::build(ForwardIter &it, size_type k) {
+  if (k > size_) {
+    return;
+  }
+  build(it, 2 * k);
+  data_[k] = *it;
+  ++it;
+  build(it, 2 * k + 1);
+}
+
+template <class T, class Compared>
+template <class ForwardIter, class OutputIter>
+OutputIter eytzinger_array<T, Compared>::lower_bound(ForwardIter first,
+                                                     ForwardIter last,
+                                                     OutputIter result) const {
+  // 每个查找都走满树的高度，越过叶子后一律向右，不影响结果
+  const auto levels = static_cast<size_type>(std::bit_width(size_));
+  size_type k[kEytzingerBatch];
+  ForwardIter key[kEytzingerBatch];
+  while (first != last) {
+    size_type m = 0;
+    for (; m < kEytzingerBatch && first != last; ++m, ++first) {
+      k[m] = 1;
+      key[m] = first;
+    }
+    for (size_type level = 0; level < levels; ++level) {
+      for (size_type j = 0; j < m; ++j) {
+        const size_type node = k[j] <= size_ ? k[j] : 0;
+        const bool right =
+            static_cast<bool>(k[j] > size_) | comp_(data_[node], *key[j]);
+        k[j] = 2 * k[j] + static_cast<size_type>(right);
+        prefetch_descendants(k[j]);
+      }
+    }
+    for (size_type j = 0; j < m; ++j) {
+      *result = decode(k[j]);
+      ++result;
+    }
+  }
+  return result;
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_EYTZINGER_H_
@@ -2,8 +2,13 @@
 #define MYTINYSTL_HEAP_ALGO_H
 
 // 这个头文件包含heap的四个算法：push_heap,pop_heap,sort_heap,make_heap
+// 以及它们的 d 叉堆版本
 
+#include <cstddef>
+
+#include "functional.h"
 #include "iterator.h"
+#include "util.h"
 
 namespace mystl {
 /********************************************************** */
@@ -15,17 +20,17 @@ void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex,
   auto parent = (holeIndex - 1) / 2;
   while (holeIndex > topIndex && *(first + parent) < value) {
     // 使用operator<,所以heap为大顶堆
-    *(first + holeIndex) = *(first + parent);
+    *(first + holeIndex) = mystl::move(*(first + parent));
     holeIndex = parent;
     parent = (holeIndex - 1) / 2;
   }
-  *(first + holeIndex) = value;
+  *(first + holeIndex) = mystl::move(value);
 }
 
 template <class RandomIter, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance *) {
   mystl::push_heap_aux(first, last - first - 1, static_cast<Distance>(0),
-                       *(last - 1));
+                       mystl::move(*(last - 1)));
 }
 
 template <class RandomIter> void push_heap(RandomIter first, RandomIter last) {
@@ -39,17 +44,17 @@ void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex,
                    T value, Compared comp) {
   auto parent = (holeIndex - 1) / 2;
   while (holeIndex > topIndex && comp(*(first + parent), value)) {
-    *(first + holeIndex) = *(first + parent);
+    *(first + holeIndex) = mystl::move(*(first + parent));
     holeIndex = parent;
     parent = (holeIndex - 1) / 2;
   }
-  *(first + holeIndex) = value;
+  *(first + holeIndex) = mystl::move(value);
 }
 
 template <class RandomIter, class Compared, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance *, Compared comp) {
   mystl::push_heap_aux(first, last - first - 1, static_cast<Distance>(0),
-                       *(last - 1), comp);
+                       mystl::move(*(last - 1)), comp);
 }
 
 template <class RandomIter, class Compared>
@@ -62,6 +67,9 @@ void push_heap(RandomIter first, RandomIter last, Compared comp) {
 // 该函数接受两个迭代器，表示heap容器的首尾，将heap的根节点取出放到容器尾部，调整heap
 /*****************************************************************************
  */
+// adjust_heap 自底向上调整：空穴沿较大的子节点一直下降到叶子，每层只比较
+// 两个子节点，再把 value 从叶子处上滤。value 通常来自堆尾，上滤很少超过
+// 一两层，比逐层再与 value 比较的下滤少约一半的比较。元素一律移动而不复制
 template <class RandomIter, class T, class Distance>
 void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value) {
   // 先进行下滤(percolate down)过程
@@ -70,28 +78,29 @@ void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value) {
   while (rchild < len) {
     if (*(first + rchild) < *(first + rchild - 1))
       --rchild; // 左子节点更大
-    *(first + holeIndex) = *(first + rchild);
+    *(first + holeIndex) = mystl::move(*(first + rchild));
     holeIndex = rchild;
     rchild = 2 * (rchild + 1);
   }
   if (rchild == len) {
-    *(first + holeIndex) = *(first + rchild - 1);
+    *(first + holeIndex) = mystl::move(*(first + rchild - 1));
     holeIndex = rchild - 1;
   }
   // 再进行上滤(percolate up)过程
-  mystl::push_heap_aux(first, holeIndex, topIndex, value);
+  mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value));
 }
 
 template <class RandomIter, class T, class Distance>
 void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value,
                   Distance *) {
   // 先将首值调至尾节点，然后调整[first, last - 1)使之重新成为一个 max-heap
-  *result = *first;
-  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, value);
+  *result = mystl::move(*first);
+  mystl::adjust_heap(first, static_cast<Distance>(0), last - first,
+                     mystl::move(value));
 }
 
 template <class RandomIter> void pop_heap(RandomIter first, RandomIter last) {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1),
+  mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)),
                       distance_type(first));
 }
 
@@ -105,30 +114,30 @@ void adjust_heap(RandomIter first, Distance holeIndex, Distance len, T value,
   while (rchild < len) {
     if (comp(*(first + rchild), *(first + rchild - 1)))
       --rchild; // 左子节点更大
-    *(first + holeIndex) = *(first + rchild);
+    *(first + holeIndex) = mystl::move(*(first + rchild));
     holeIndex = rchild;
     rchild = 2 * (rchild + 1);
   }
   if (rchild == len) {
-    *(first + holeIndex) = *(first + rchild - 1);
+    *(first + holeIndex) = mystl::move(*(first + rchild - 1));
     holeIndex = rchild - 1;
   }
   // 再进行上滤(percolate up)过程
-  mystl::push_heap_aux(first, holeIndex, topIndex, value, comp);
+  mystl::push_heap_aux(first, holeIndex, topIndex, mystl::move(value), comp);
 }
 
 template <class RandomIter, class T, class Distance, class Compared>
 void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value,
                   Distance *, Compared comp) {
   // 先将首值调至尾节点，然后调整[first, last - 1)使之重新成为一个 max-heap
-  *result = *first;
-  mystl::adjust_heap(first, static_cast<Distance>(0), last - first, value,
-                     comp);
+  *result = mystl::move(*first);
+  mystl::adjust_heap(first, static_cast<Distance>(0), last - first,
+                     mystl::move(value), comp);
 }
 
 template <class RandomIter, class Compared>
 void pop_heap(RandomIter first, RandomIter last, Compared comp) {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1),
+  mystl::pop_heap_aux(first, last - 1, last - 1, mystl::move(*(last - 1)),
                       distance_type(first), comp);
 }
 /*****************************************************************************************/
@@ -166,7 +175,8 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance *) {
   auto holeIndex = (len - 2) / 2;
   while (true) {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex));
+    mystl::adjust_heap(first, holeIndex, len,
+                       mystl::move(*(first + holeIndex)));
     if (holeIndex == 0)
       return;
     holeIndex--;
@@ -187,7 +197,8 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance *,
   auto holeIndex = (len - 2) / 2;
   while (true) {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex), comp);
+    mystl::adjust_heap(first, holeIndex, len,
+                       mystl::move(*(first + holeIndex)), comp);
     if (holeIndex == 0)
       return;
     holeIndex--;
@@ -199,5 +210,154 @@ void make_heap(RandomIter first, RandomIter last, Compared comp) {
   mystl::make_heap_aux(first, last, distance_type(first), comp);
 }
 
+/*****************************************************************************************/
+// dary_push_heap / dary_pop_heap / dary_make_heap / dary_sort_heap
+// d 叉堆版本，第 i 个节点的子节点为 D * i + 1 到 D * i + D
+// 树高降为 log_D(n)，同一节点的子节点相邻存放，元素较多时 4 叉或 8 叉堆
+// 访问的缓存行更少。D 为 2 时与上面的二叉堆算法得到相同的堆
+/*****************************************************************************************/
+// 把 value 从 holeIndex 处上滤
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_sift_up(RandomIter first, Distance holeIndex, T value,
+                  Compared comp) {
+  static_assert(D >= 2, "heap arity must be at least 2");
+  while (holeIndex > 0) {
+    const Distance parent = (holeIndex - 1) / static_cast<Distance>(D);
+    if (!comp(*(first + parent), value))
+      break;
+    *(first + holeIndex) = mystl::move(*(first + parent));
+    holeIndex = parent;
+  }
+  *(first + holeIndex) = mystl::move(value);
+}
+
+// 把 value 从 holeIndex 处下滤，len 为堆的大小
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_sift_down(RandomIter first, Distance holeIndex, Distance len,
+                    T value, Compared comp) {
+  static_assert(D >= 2, "heap arity must be at least 2");
+  const auto d = static_cast<Distance>(D);
+  while (true) {
+    const Distance child = d * holeIndex + 1;
+    if (child >= len)
+      break;
+    // 在至多 D 个子节点中找出最大者
+    const Distance child_end = len - child > d ? child + d : len;
+    Distance best = child;
+    for (Distance c = child + 1; c < child_end; ++c) {
+      if (comp(*(first + best), *(first + c)))
+        best = c;
+    }
+    if (!comp(value, *(first + best)))
+      break;
+    *(first + holeIndex) = mystl::move(*(first + best));
+    holeIndex = best;
+  }
+  *(first + holeIndex) = mystl::move(value);
+}
+
+// 自底向上调整：空穴沿最大的子节点一直下降到叶子，每层 D - 1 次比较，
+// 再把 value 上滤，但不越过 holeIndex 原来的位置。
+// 用于 pop 和建堆，value 多半会回到接近叶子的位置，比 dary_sift_down
+// 每层少一次与 value 的比较
+template <size_t D, class RandomIter, class Distance, class T, class Compared>
+void dary_adjust_heap(RandomIter first, Distance holeIndex, Distance len,
+                      T value, Compared comp) {
+  static_assert(D >= 2, "heap arity must be at least 2");
+  const auto d = static_cast<Distance>(D);
+  const Distance topIndex = holeIndex;
+  while (true) {
+    const Distance child = d * holeIndex + 1;
+    if (child >= len)
+      break;
+    const Distance child_end = len - child > d ? child + d : len;
+    Distance best = child;
+    for (Distance c = child + 1; c < child_end; ++c) {
+      if (comp(*(first + best), *(first + c)))
+        best = c;
+    }
+    *(first + holeIndex) = mystl::move(*(first + best));
+    holeIndex = best;
+  }
+  while (holeIndex > topIndex) {
+    const Distance parent = (holeIndex - 1) / d;
+    if (!comp(*(first + parent), value))
+      break;
+    *(first + holeIndex) = mystl::move(*(first + parent));
+    holeIndex = parent;
+  }
+  *(first + holeIndex) = mystl::move(value);
+}
+
+// 新元素已经位于 last - 1 处
+template <size_t D, class RandomIter, class Compared>
+void dary_push_heap(RandomIter first, RandomIter last, Compared comp) {
+  const auto len = last - first;
+  if (len < 2)
+    return;
+  auto value = mystl::move(*(last - 1));
+  mystl::dary_sift_up<D>(first, len - 1, mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter>
+void dary_push_heap(RandomIter first, RandomIter last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_push_heap<D>(first, last, mystl::less<value_type>());
+}
+
+// 把堆顶移到 last - 1 处
+template <size_t D, class RandomIter, class Compared>
+void dary_pop_heap(RandomIter first, RandomIter last, Compared comp) {
+  const auto len = last - first;
+  if (len < 2)
+    return;
+  auto value = mystl::move(*(last - 1));
+  *(last - 1) = mystl::move(*first);
+  mystl::dary_adjust_heap<D>(first, static_cast<decltype(len)>(0), len - 1,
+                             mystl::move(value), comp);
+}
+
+template <size_t D, class RandomIter>
+void dary_pop_heap(RandomIter first, RandomIter last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_pop_heap<D>(first, last, mystl::less<value_type>());
+}
+
+template <size_t D, class RandomIter, class Compared>
+void dary_make_heap(RandomIter first, RandomIter last, Compared comp) {
+  const auto len = last - first;
+  if (len < 2)
+    return;
+  // 从最后一个非叶子节点开始依次下滤
+  for (auto holeIndex = (len - 2) / static_cast<decltype(len)>(D);;
+       --holeIndex) {
+    auto value = mystl::move(*(first + holeIndex));
+    mystl::dary_adjust_heap<D>(first, holeIndex, len, mystl::move(value),
+                               comp);
+    if (holeIndex == 0)
+      return;
+  }
+}
+
+template <size_t D, class RandomIter>
+void dary_make_heap(RandomIter first, RandomIter last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_make_heap<D>(first, last, mystl::less<value_type>());
+}
+
+template <size_t D, class RandomIter, class Compared>
+void dary_sort_heap(RandomIter first, RandomIter last, Compared comp) {
+  while (last - first > 1) {
+    mystl::dary_pop_heap<D>(first, last, comp);
+    --last;
+  }
+}
+
+template <size_t D, class RandomIter>
+void dary_sort_heap(RandomIter first, RandomIter last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::dary_sort_heap<D>(first, last, mystl::less<value_type>());
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_HEAP_ALGO_H
@@ -0,0 +1,228 @@
+#ifndef MYTINYSTL_INDEXED_HEAP_H_
+#define MYTINYSTL_INDEXED_HEAP_H_
+
+// 这个头文件包含一个模板类 indexed_heap
+// indexed_heap : 可寻址的 d 叉堆，可以通过句柄修改或删除堆中的任意元素
+
+// notes:
+//
+// push 返回一个句柄，元素离开堆之前句柄一直有效，离开后句柄会被复用。
+// 堆数组中存放元素及其句柄，另用一个 mystl::vector 记录每个句柄在堆数组中
+// 的位置，每次移动元素时同步更新。
+// 与 priority_queue 相同，比较函数为 less 时堆顶为最大的元素；
+// decrease_key 把元素改为优先级不低于原值的新值(最小堆中即减小键值)，
+// 只需上滤，适合 Dijkstra 等图算法；update 可以向任意方向修改
+
+#include <cstddef>
+
+#include "exceptdef.h"
+#include "functional.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+template <class T, class Compare = mystl::less<T>, size_t Arity = 4>
+class indexed_heap {
+  static_assert(Arity >= 2, "heap arity must be at least 2");
+
+public:
+  typedef T value_type;
+  typedef Compare value_compare;
+  typedef size_t size_type;
+  typedef size_t handle_type;
+  typedef const T &const_reference;
+
+private:
+  static constexpr size_type kNoPos = static_cast<size_type>(-1);
+
+  struct entry {
+    T value;
+    handle_type handle;
+  };
+
+  mystl::vector<entry> heap_;        // 按堆序存放的元素
+  mystl::vector<size_type> pos_;     // 每个句柄在 heap_ 中的位置
+  mystl::vector<handle_type> free_;  // 可以复用的句柄
+  value_compare comp_;
+
+public:
+  indexed_heap() = default;
+  explicit indexed_heap(const Compare &comp) : comp_(comp) {}
+
+  // 容量相关操作
+  bool empty() const noexcept { return heap_.empty(); }
+  size_type size() const noexcept { return heap_.size(); }
+
+  void reserve(size_type n) {
+    heap_.reserve(n);
+    pos_.reserve(n);
+  }
+
+  // 访问元素相关操作
+  const_reference top() const {
+    MYSTL_DEBUG(!empty());
+    return heap_.front().value;
+  }
+
+  handle_type top_handle() const {
+    MYSTL_DEBUG(!empty());
+    return heap_.front().handle;
+  }
+
+  bool contains(handle_type h) const noexcept {
+    return h < pos_.size() && pos_[h] != kNoPos;
+  }
+
+  const_reference value(handle_type h) const {
+    MYSTL_DEBUG(contains(h));
+    return heap_[pos_[h]].value;
+  }
+
+  // 修改容器相关操作
+  handle_type push(const value_type &value) {
+    return push_aux(value_type(value));
+  }
+
+  handle_type push(value_type &&value) { return push_aux(mystl::move(value)); }
+
+  void pop() {
+    MYSTL_DEBUG(!empty());
+    remove_at(0);
+  }
+
+  // value 的优先级不能低于原值
+  void decrease_key(handle_type h, const value_type &value) {
+    MYSTL_DEBUG(contains(h) && !comp_(value, heap_[pos_[h]].value));
+    const size_type i = pos_[h];
+    heap_[i].value = value;
+    sift_up(i);
+  }
+
+  void update(handle_type h, const value_type &value) {
+    MYSTL_DEBUG(contains(h));
+    const size_type i = pos_[h];
+    const bool up = comp_(heap_[i].value, value);
+    heap_[i].value = value;
+    if (up) {
+      sift_up(i);
+    } else {
+      sift_down(i);
+    }
+  }
+
+  void erase(handle_type h) {
+    MYSTL_DEBUG(contains(h));
+    remove_at(pos_[h]);
+  }
+
+  void clear() {
+    heap_.clear();
+    pos_.clear();
+    free_.clear();
+  }
+
+  void swap(indexed_heap &rhs) noexcept {
+    heap_.swap(rhs.heap_);
+    pos_.swap(rhs.pos_);
+    free_.swap(rhs.free_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+private:
+  handle_type push_aux(value_type &&value);
+  void remove_at(size_type i);
+  void sift_up(size_type i);
+  void sift_down(size_type i);
+};
+
+/*****************************************************************************************/
+// helper function
+
+template <class T, class Compare, size_t Arity>
+typename indexed_heap<T, Compare, Arity>::handle_type
+indexed_heap<T, Compare, Arity>::push_aux(value_type &&value) {
+  handle_type h;
+  if (!free_.empty()) {
+    h = free_.back();
+    free_.pop_back();
+  } else {
+    h = pos_.size();
+    pos_.push_back(kNoPos);
+  }
+  heap_.push_back(entry{mystl::move(value), h});
+  pos_[h] = heap_.size() - 1;
+  sift_up(heap_.size() - 1);
+  return h;
+}
+
+// 用最后一个元素填补位置 i，再向合适的方向调整
+template <class T, class Compare, size_t Arity>
+void indexed_heap<T, Compare, Arity>::remove_at(size_type i) {
+  const handle_type h = heap_[i].handle;
+  const size_type last = heap_.size() - 1;
+  if (i != last) {
+    const bool up = comp_(heap_[i].value, heap_[last].value);
+    heap_[i] = mystl::move(heap_[last]);
+    pos_[heap_[i].handle] = i;
+    heap_.pop_back();
+    if (up) {
+      sift_up(i);
+    } else {
+      sift_down(i);
+    }
+  } else {
+    heap_.pop_back();
+  }
+  pos_[h] = kNoPos;
+  free_.push_back(h);
+}
+
+template <class T, class Compare, size_t Arity>
+void indexed_heap<T, Compare, Arity>::sift_up(size_type i) {
+  entry e = mystl::move(heap_[i]);
+  while (i > 0) {
+    const size_type parent = (i - 1) / Arity;
+    if (!comp_(heap_[parent].value, e.value))
+      break;
+    heap_[i] = mystl::move(heap_[parent]);
+    pos_[heap_[i].handle] = i;
+    i = parent;
+  }
+  pos_[e.handle] = i;
+  heap_[i] = mystl::move(e);
+}
+
+template <class T, class Compare, size_t Arity>
+void indexed_heap<T, Compare, Arity>::sift_down(size_type i) {
+  const size_type len = heap_.size();
+  entry e = mystl::move(heap_[i]);
+  while (true) {
+    const size_type child = Arity * i + 1;
+    if (child >= len)
+      break;
+    const size_type child_end = len - child > Arity ? child + Arity : len;
+    size_type best = child;
+    for (size_type c = child + 1; c < child_end; ++c) {
+      if (comp_(heap_[best].value, heap_[c].value))
+        best = c;
+    }
+    if (!comp_(e.value, heap_[best].value))
+      break;
+    heap_[i] = mystl::move(heap_[best]);
+    pos_[heap_[i].handle] = i;
+    i = best;
+  }
+  pos_[e.handle] = i;
+  heap_[i] = mystl::move(e);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare, size_t Arity>
+void swap(indexed_heap<T, Compare, Arity> &lhs,
+          indexed_heap<T, Compare, Arity> &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_INDEXED_HEAP_H_
@@ -301,6 +301,110 @@ bool operator<=(const reverse_iterator<Iterator> &lhs,
   return !(lhs > rhs);
 }
 
+/*****************************************************************************************/
+// segmented_iterator_traits
+// 分段迭代器的元素存放在若干段连续的空间中，例如 deque 的各个缓冲区。
+// 这样的迭代器特化 segmented_iterator_traits，令 is_segmented 为 m_true_type，
+// 并提供：
+//   segment_iterator / local_iterator : 段的迭代器与段内的迭代器（通常为指针）
+//   segment(it) / local(it)           : it 所在的段以及在段内的位置
+//   begin(seg) / end(seg)             : 段内的首尾
+//   compose(seg, local)               : 由段与段内位置得到迭代器
+// 算法据此把区间拆成若干段，每段用段内迭代器处理
+/*****************************************************************************************/
+template <class Iterator> struct segmented_iterator_traits {
+  typedef m_false_type is_segmented;
+};
+
+template <class Iterator>
+struct is_segmented_iterator
+    : public segmented_iterator_traits<Iterator>::is_segmented {};
+
+// 依次对 [first, last) 的每一段调用 f(seg, local_first, local_last)，
+// f 返回 true 时停止，返回值表示是否被 f 停止
+template <class SegIter, class Function>
+bool for_each_segment(SegIter first, SegIter last, Function f) {
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast) {
+    return f(sfirst, traits::local(first), traits::local(last));
+  }
+  if (f(sfirst, traits::local(first), traits::end(sfirst))) {
+    return true;
+  }
+  for (++sfirst; sfirst != slast; ++sfirst) {
+    if (f(sfirst, traits::begin(sfirst), traits::end(sfirst))) {
+      return true;
+    }
+  }
+  return f(slast, traits::begin(slast), traits::local(last));
+}
+
+// 从后往前依次处理每一段
+template <class SegIter, class Function>
+bool for_each_segment_backward(SegIter first, SegIter last, Function f) {
+  typedef segmented_iterator_traits<SegIter> traits;
+  const auto sfirst = traits::segment(first);
+  auto slast = traits::segment(last);
+  if (sfirst == slast) {
+    return f(slast, traits::local(first), traits::local(last));
+  }
+  if (f(slast, traits::begin(slast), traits::local(last))) {
+    return true;
+  }
+  for (--slast; slast != sfirst; --slast) {
+    if (f(slast, traits::begin(slast), traits::end(slast))) {
+      return true;
+    }
+  }
+  return f(sfirst, traits::local(first), traits::end(sfirst));
+}
+
+// 以分段迭代器 result 为目标，按目标的段把可随机访问的 [first, last) 拆开，
+// 对每段调用 f(src_first, src_last, local_first)，f 返回段内写入结束的位置，
+// 返回写入结束的位置
+template <class RandomIter, class SegIter, class Function>
+SegIter for_each_output_segment(RandomIter first, RandomIter last,
+                                SegIter result, Function f) {
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto seg = traits::segment(result);
+  auto local = traits::local(result);
+  for (auto n = last - first; n > 0;) {
+    if (local == traits::end(seg)) {
+      ++seg;
+      local = traits::begin(seg);
+    }
+    auto len = traits::end(seg) - local;
+    len = n < len ? n : len;
+    local = f(first, first + len, local);
+    first += len;
+    n -= len;
+  }
+  return traits::compose(seg, local);
+}
+
+// 从后往前写入 result 之前的位置，返回写入开始的位置
+template <class RandomIter, class SegIter, class Function>
+SegIter for_each_output_segment_backward(RandomIter first, RandomIter last,
+                                         SegIter result, Function f) {
+  typedef segmented_iterator_traits<SegIter> traits;
+  auto seg = traits::segment(result);
+  auto local = traits::local(result);
+  for (auto n = last - first; n > 0;) {
+    if (local == traits::begin(seg)) {
+      --seg;
+      local = traits::end(seg);
+    }
+    auto len = local - traits::begin(seg);
+    len = n < len ? n : len;
+    local = f(last - len, last, local);
+    last -= len;
+    n -= len;
+  }
+  return traits::compose(seg, local);
+}
+
 } // namespace mystl
 
 #endif // !MYTINYSTL_ITERATOR_H_
\ No newline at end of file
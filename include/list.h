@@ -15,9 +15,25 @@
 // *push_front
 // *push_back
 // *insert
+//
+// 节点的分配：
+// fill_init、copy_init、fill_insert、copy_insert 一次创建多个节点时，
+// 节点成批分配，每批一次分配，批内的节点在内存中连续。每个节点记录所在的批，
+// 批的头部记录其中还未销毁的节点个数，最后一个节点销毁时释放整批，
+// 所以节点被 splice 到其他 list 后仍然有效。同一批的节点可能属于不同的 list，
+// 由不同的线程销毁，所以计数是原子的
+//
+// 排序：
+// sort 为自底向上的归并排序，不递归，也不需要求区间长度。节点逐个放入 64 个桶，
+// 第 i 个桶中为长度 2^i 的有序段，合并时只沿 next 连接，排好后再恢复 prev。
+// sort_by_pointers 把节点指针复制到数组中排序后重新连接，排序时访问连续的数组，
+// 元素多时更快，但需要 O(n) 的额外空间；以 mystl::less 比较整数时使用基数排序。
+// 两者都是稳定的
+#include <atomic>
 #include <initializer_list>
 #include <type_traits>
 
+#include "algo.h"
 #include "algobase.h"
 #include "allocator.h"
 #include "construct.h"
@@ -26,11 +42,30 @@
 #include "iterator.h"
 #include "memory.h"
 #include "util.h"
+#include "vector.h"
 
 namespace mystl {
 template <class T> struct list_node_base;
 template <class T> struct list_node;
 
+// 一批节点空间的头部，占用这批空间的第一个节点位置
+struct list_node_batch {
+  std::atomic<size_t> live; // 这批空间中还未销毁的节点个数
+};
+
+// 每批最多的节点个数
+template <class T> struct list_batch_size {
+  static constexpr size_t value =
+      sizeof(list_node<T>) < 4096 ? 65536 / sizeof(list_node<T>) : 16;
+};
+
+// sort_by_pointers 是否可以用基数排序：以 mystl::less 比较 bool 以外的整数
+template <class T, class Compared>
+struct list_radix_sortable
+    : public m_bool_constant<std::is_integral<T>::value &&
+                             !std::is_same<T, bool>::value &&
+                             std::is_same<Compared, mystl::less<T>>::value> {};
+
 template <class T> struct node_traits {
   typedef list_node_base<T> *base_ptr;
   typedef list_node<T> *node_ptr;
@@ -57,7 +92,8 @@ template <class T> struct list_node : public list_node_base<T> {
   typedef typename node_traits<T>::base_ptr base_ptr;
   typedef typename node_traits<T>::node_ptr node_ptr;
 
-  T value; // 作用域
+  T value;               // 作用域
+  list_node_batch *batch; // 所在的一批空间，单独分配时为 nullptr
 
   list_node() = default;
   list_node(const T &v) : value(v) {}
@@ -443,9 +479,13 @@ public:
   void merge(list &x) { merge(x, mystl::less<T>()); }
   template <class Compared> void merge(list &x, Compared comp);
 
-  void sort() { list_sort(begin(), end(), size(), mystl::less<T>()); }
-  template <class Compared> void sort(Compared comp) {
-    list_sort(begin(), end(), size(), comp);
+  void sort() { sort(mystl::less<T>()); }
+  template <class Compared> void sort(Compared comp);
+
+  // 排序途中抛出异常时 list 不变
+  void sort_by_pointers() { sort_by_pointers(mystl::less<T>()); }
+  template <class Compared> void sort_by_pointers(Compared comp) {
+    pointer_sort(comp, list_radix_sortable<T, Compared>());
   }
 
   void reverse();
@@ -456,6 +496,10 @@ private:
   // create/destroy node
   template <class... Args> node_ptr create_node(Args &&...args);
   void destroy_node(node_ptr p);
+  template <class Construct>
+  mystl::pair<base_ptr, base_ptr> create_nodes(size_type n,
+                                               Construct construct);
+  void destroy_nodes(base_ptr first, base_ptr last);
 
   // initialize
   void fill_init(size_type n, const value_type &value);
@@ -480,7 +524,10 @@ private:
 
   // sort
   template <class Compared>
-  iterator list_sort(iterator first, iterator last, size_type n, Compared comp);
+  static void merge_chains(base_ptr &a, base_ptr &b, Compared &comp);
+  void link_chain(base_ptr first);
+  template <class Compared> void pointer_sort(Compared comp, m_false_type);
+  template <class Compared> void pointer_sort(Compared comp, m_true_type);
 };
 /*****************************************************************************************/
 
@@ -491,7 +538,7 @@ typename list<T>::iterator list<T>::erase(const_iterator pos) {
   auto n = pos.node_;
   auto next = n->next;
   unlink_nodes(n, n);
-  destroy(n->as_node());
+  destroy_node(n->as_node());
   --size_;
   return iterator(next);
 }
@@ -570,7 +617,7 @@ void list<T>::splice(const_iterator pos, list &x, const_iterator it) {
     link_nodes(pos.node_, f, f);
 
     ++size_;
-    --size_;
+    --x.size_;
   }
 }
 
@@ -696,6 +743,7 @@ typename list<T>::node_ptr list<T>::create_node(Args &&...args) {
                               mystl::forward<Args>(args)...);
     p->prev = nullptr;
     p->next = nullptr;
+    p->batch = nullptr;
   } catch (...) {
     node_allocator::deallocate(p);
     throw;
@@ -703,10 +751,68 @@ typename list<T>::node_ptr list<T>::create_node(Args &&...args) {
   return p;
 }
 
-// 销毁节点
+// 销毁节点，成批分配的节点在这批的最后一个节点销毁时释放整批
 template <class T> void list<T>::destroy_node(node_ptr p) {
   data_allocator::destroy(mystl::address_of(p->value));
-  node_allocator::deallocate(p);
+  list_node_batch *batch = p->batch;
+  if (batch == nullptr) {
+    node_allocator::deallocate(p);
+  } else if (batch->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    node_allocator::deallocate(reinterpret_cast<node_ptr>(batch));
+  }
+}
+
+// 成批创建 n 个节点，construct(p) 在 p 处构造第 i 个节点的值。
+// 节点以 prev/next 连成一串，返回首尾节点，首节点的 prev 与尾节点的 next
+// 由调用者连接。每批分配 count + 1 个节点的空间，第一个位置存放批的头部
+template <class T>
+template <class Construct>
+mystl::pair<typename list<T>::base_ptr, typename list<T>::base_ptr>
+list<T>::create_nodes(size_type n, Construct construct) {
+  MYSTL_DEBUG(n > 0);
+  list_node_base<T> head; // 临时的头节点，head.next 为第一个节点
+  base_ptr last = &head;
+  list_node_batch *batch = nullptr;
+  try {
+    while (n > 0) {
+      const size_type count =
+          mystl::min(n, static_cast<size_type>(list_batch_size<T>::value));
+      node_ptr block = node_allocator::allocate(count + 1);
+      batch = ::new (static_cast<void *>(block)) list_node_batch();
+      batch->live.store(0, std::memory_order_relaxed);
+      for (node_ptr p = block + 1; p != block + count + 1; ++p) {
+        construct(mystl::address_of(p->value));
+        p->batch = batch;
+        batch->live.fetch_add(1, std::memory_order_relaxed);
+        p->prev = last;
+        last->next = p->as_base();
+        last = p->as_base();
+      }
+      n -= count;
+    }
+  } catch (...) {
+    // 还没有构造任何节点的一批空间不会由 destroy_node 释放
+    if (batch != nullptr && batch->live.load(std::memory_order_relaxed) == 0) {
+      node_allocator::deallocate(reinterpret_cast<node_ptr>(batch));
+    }
+    if (last != &head) {
+      destroy_nodes(head.next, last);
+    }
+    throw;
+  }
+  return mystl::make_pair(head.next, last);
+}
+
+// 销毁以 next 相连的 [first, last] 中的节点
+template <class T> void list<T>::destroy_nodes(base_ptr first, base_ptr last) {
+  while (true) {
+    base_ptr next = first->next;
+    destroy_node(first->as_node());
+    if (first == last) {
+      break;
+    }
+    first = next;
+  }
 }
 
 // 用n个元素初始化容器
@@ -714,17 +820,18 @@ template <class T>
 void list<T>::fill_init(size_type n, const value_type &value) {
   node_ = base_allocator::allocate(1);
   node_->unlink();
-  size_ = n;
-  try {
-    for (; n > 0; --n) {
-      auto node = create_node(value);
-      link_nodes_at_back(node->as_base(), node->as_base());
+  size_ = 0;
+  if (n != 0) {
+    try {
+      auto nodes = create_nodes(
+          n, [&value](T *p) { data_allocator::construct(p, value); });
+      link_nodes_at_back(nodes.first, nodes.second);
+      size_ = n;
+    } catch (...) {
+      base_allocator::deallocate(node_);
+      node_ = nullptr;
+      throw;
     }
-  } catch (...) {
-    clear();
-    base_allocator::deallocate(node_);
-    node_ = nullptr;
-    throw;
   }
 }
 
@@ -734,18 +841,21 @@ template <class Iter>
 void list<T>::copy_init(Iter first, Iter last) {
   node_ = base_allocator::allocate(1);
   node_->unlink();
-  size_type n = mystl::distance(first, last);
-  size_ = n;
-  try {
-    for (; n > 0; --n, ++first) {
-      auto node = create_node(*first);
-      link_nodes_at_back(node->as_base(), node->as_base());
+  size_ = 0;
+  const size_type n = mystl::distance(first, last);
+  if (n != 0) {
+    try {
+      auto nodes = create_nodes(n, [&first](T *p) {
+        data_allocator::construct(p, *first);
+        ++first;
+      });
+      link_nodes_at_back(nodes.first, nodes.second);
+      size_ = n;
+    } catch (...) {
+      base_allocator::deallocate(node_);
+      node_ = nullptr;
+      throw;
     }
-  } catch (...) {
-    clear();
-    base_allocator::deallocate(node_);
-    node_ = nullptr;
-    throw;
   }
 }
 
@@ -831,36 +941,14 @@ void list<T>::copy_assign(Iter first, Iter last) {
 template <class T>
 typename list<T>::iterator list<T>::fill_insert(const_iterator pos, size_type n,
                                                 const value_type &value) {
-  iterator r(pos.node_);
-  if (n != 0) {
-    const auto add_size = n;
-    auto node = create_node(value);
-    node->prev = nullptr;
-    r = iterator(node);
-    iterator end = r;
-    try {
-      // 前面已经创建了一个节点，还需n - 1个
-      for (--n; n > 0; --n, ++end) {
-        auto next = create_node(value);
-        end.node_->next = next->as_base(); // link node
-        next->prev = end.node_;
-      }
-      size_ += add_size;
-    } catch (...) {
-      auto enode = end.node_;
-      while (true) {
-        auto prev = enode->prev;
-        destroy_node(enode->as_node());
-        if (prev == nullptr) {
-          break;
-        }
-        enode = prev;
-      }
-      throw;
-    }
-    link_nodes(pos.node_, r.node_, end.node_);
-  }
-  return r;
+  if (n == 0) {
+    return iterator(pos.node_);
+  }
+  auto nodes = create_nodes(
+      n, [&value](T *p) { data_allocator::construct(p, value); });
+  link_nodes(pos.node_, nodes.first, nodes.second);
+  size_ += n;
+  return iterator(nodes.first);
 }
 
 // 在pos处插入[first,last)的元素
@@ -868,106 +956,215 @@ template <class T>
 template <class Iter>
 typename list<T>::iterator list<T>::copy_insert(const_iterator pos, size_type n,
                                                 Iter first) {
-  iterator r(pos.node_);
-  if (n != 0) {
-    const auto add_size = n;
-    auto node = create_node(*first);
-    node->prev = nullptr;
-    r = iterator(node);
-    iterator end = r;
-    try {
-      for (--n, ++first; n > 0; --n, ++first, ++end) {
-        auto next = create_node(*first);
-        end.node_->next = next->as_base(); // link node
-        next->prev = end.node_;
+  if (n == 0) {
+    return iterator(pos.node_);
+  }
+  auto nodes = create_nodes(n, [&first](T *p) {
+    data_allocator::construct(p, *first);
+    ++first;
+  });
+  link_nodes(pos.node_, nodes.first, nodes.second);
+  size_ += n;
+  return iterator(nodes.first);
+}
+
+// 自底向上的归并排序
+template <class T>
+template <class Compared>
+void list<T>::sort(Compared comp) {
+  if (size_ < 2) {
+    return;
+  }
+  // 各段以 next 相连、以 nullptr 结尾，bins[i] 为空或为长度 2^i 的有序段，
+  // 下标小的桶中的元素在原序列中位于下标大的桶之后
+  base_ptr bins[64] = {};
+  size_t fill = 0;
+  base_ptr rest = node_->next;
+  base_ptr carry = nullptr;
+  node_->prev->next = nullptr;
+  try {
+    while (rest != nullptr) {
+      carry = rest;
+      rest = rest->next;
+      carry->next = nullptr;
+      size_t i = 0;
+      for (; i < fill && bins[i] != nullptr; ++i) {
+        merge_chains(bins[i], carry, comp);
+        carry = bins[i];
+        bins[i] = nullptr;
       }
-      size_ += add_size;
-    } catch (...) {
-      auto enode = end.node_;
-      while (true) {
-        auto prev = enode->prev;
-        destroy_node(enode->as_node());
-        if (prev == nullptr) {
-          break;
+      bins[i] = carry;
+      carry = nullptr;
+      if (i == fill) {
+        ++fill;
+      }
+    }
+    for (size_t i = 1; i < fill; ++i) {
+      if (bins[i - 1] != nullptr) {
+        if (bins[i] == nullptr) {
+          bins[i] = bins[i - 1];
+        } else {
+          merge_chains(bins[i], bins[i - 1], comp);
         }
-        enode = prev;
+        bins[i - 1] = nullptr;
       }
-      throw;
     }
-    link_nodes(pos.node_, r.node_, end.node_);
+  } catch (...) {
+    // 把所有节点按任意顺序连回 list
+    base_ptr first = rest;
+    auto append = [&first](base_ptr chain) {
+      if (chain != nullptr) {
+        base_ptr tail = chain;
+        while (tail->next != nullptr) {
+          tail = tail->next;
+        }
+        tail->next = first;
+        first = chain;
+      }
+    };
+    append(carry);
+    for (size_t i = 0; i < fill; ++i) {
+      append(bins[i]);
+    }
+    link_chain(first);
+    throw;
   }
-  return r;
+  link_chain(bins[fill - 1]);
 }
 
-// 对list进行归并排序,并返回一个迭代器指向区间最小元素的位置
+// 稳定地合并两个以 nullptr 结尾的有序段，a 中的元素在前，结果放在 a 中，b 置空。
+// 比较抛出异常时把剩余的部分接在已合并的部分之后，同样放在 a 中
 template <class T>
 template <class Compared>
-typename list<T>::iterator list<T>::list_sort(iterator first1, iterator last2,
-                                              size_type n, Compared comp) {
-  if (n < 2) {
-    return first1;
-  }
-  if (n == 2) {
-    if (comp(*--last2, *first1)) {
-      auto ln = last2.node_;
-      unlink_nodes(ln, ln);
-      link_nodes(first1.node_, ln, ln);
-      return last2;
+void list<T>::merge_chains(base_ptr &a, base_ptr &b, Compared &comp) {
+  list_node_base<T> head;
+  base_ptr tail = &head;
+  try {
+    while (a != nullptr && b != nullptr) {
+      if (comp(b->as_node()->value, a->as_node()->value)) {
+        tail->next = b;
+        tail = b;
+        b = b->next;
+      } else {
+        tail->next = a;
+        tail = a;
+        a = a->next;
+      }
     }
-    return first1;
-  }
-
-  auto n2 = n / 2;
-  auto last1 = first1;
-  mystl::advance(last1, n2);
-  auto result = first1 = list_sort(first1, last1, n2, comp); // 前半段的最小位置
-  auto first2 = last1 =
-      list_sort(last1, last2, n - n2, comp); // 后半段的最小位置
-
-  // 把较小的一段区间移到前面
-  if (comp(*first2, *first1)) {
-    auto m = first2;
-    ++m;
-    for (; m != last2 && comp(*m, *first1); ++m) {
-      ;
+  } catch (...) {
+    tail->next = a;
+    while (tail->next != nullptr) {
+      tail = tail->next;
     }
-    auto f = first2.node_;
-    auto l = m.node_->prev;
-    result = first2;
-    last1 = first2 = m;
-    unlink_nodes(f, l);
-    m = first1;
-    ++m;
-    link_nodes(first1.node_, f, l);
-    first1 = m;
-  } else {
-    ++first1;
+    tail->next = b;
+    a = head.next;
+    b = nullptr;
+    throw;
   }
+  tail->next = a != nullptr ? a : b;
+  a = head.next;
+  b = nullptr;
+}
 
-  // 合并两段有序区间
-  while (first1 != last1 && first2 != last2) {
-    if (comp(*first2, *first1)) {
-      auto m = first2;
-      ++m;
-      for (; m != last2 && comp(*m, *first1); ++m) {
-        ;
-      }
-      auto f = first2.node_;
-      auto l = m.node_->prev;
-      if (last1 == first2) {
-        last1 = m;
-      }
-      first2 = m;
-      unlink_nodes(f, l);
-      m = first1;
-      ++m;
-      link_nodes(first1.node_, f, l);
-      first1 = m;
-    } else {
-      ++first1;
+// 把以 nullptr 结尾的 first 作为 list 的全部节点，按 next 的顺序恢复 prev
+template <class T> void list<T>::link_chain(base_ptr first) {
+  base_ptr prev = node_;
+  for (base_ptr p = first; p != nullptr; p = p->next) {
+    p->prev = prev;
+    prev->next = p;
+    prev = p;
+  }
+  prev->next = node_;
+  node_->prev = prev;
+}
+
+// 把节点指针与原来的位置复制到数组中，以 mystl::sort 排序，
+// 相等的元素按原来的位置排列，所以是稳定的
+template <class T>
+template <class Compared>
+void list<T>::pointer_sort(Compared comp, m_false_type) {
+  if (size_ < 2) {
+    return;
+  }
+  typedef mystl::pair<base_ptr, size_type> entry;
+  mystl::vector<entry> nodes;
+  nodes.reserve(size_);
+  size_type i = 0;
+  for (base_ptr p = node_->next; p != node_; p = p->next) {
+    nodes.push_back(entry(p, i++));
+  }
+  mystl::sort(nodes.begin(), nodes.end(),
+              [&comp](const entry &a, const entry &b) {
+                const T &x = a.first->as_node()->value;
+                const T &y = b.first->as_node()->value;
+                if (comp(x, y)) {
+                  return true;
+                }
+                if (comp(y, x)) {
+                  return false;
+                }
+                return a.second < b.second;
+              });
+  node_->prev->next = nullptr;
+  for (auto it = nodes.begin(); it + 1 != nodes.end(); ++it) {
+    it->first->next = (it + 1)->first;
+  }
+  nodes.back().first->next = nullptr;
+  link_chain(nodes.front().first);
+}
+
+// 整数使用最低位优先的基数排序，每趟按一个字节分配，所有键在该字节上相同时跳过
+template <class T>
+template <class Compared>
+void list<T>::pointer_sort(Compared, m_true_type) {
+  if (size_ < 2) {
+    return;
+  }
+  typedef typename std::make_unsigned<T>::type key_type;
+  // 有符号数翻转符号位后按无符号数比较
+  const key_type flip = std::is_signed<T>::value
+                            ? static_cast<key_type>(key_type(1)
+                                                    << (sizeof(T) * 8 - 1))
+                            : key_type(0);
+  struct entry {
+    key_type key;
+    base_ptr node;
+  };
+  mystl::vector<entry> a;
+  mystl::vector<entry> b;
+  a.reserve(size_);
+  b.reserve(size_);
+  size_t count[sizeof(T)][256] = {};
+  for (base_ptr p = node_->next; p != node_; p = p->next) {
+    const key_type key = static_cast<key_type>(p->as_node()->value) ^ flip;
+    a.push_back(entry{key, p});
+    b.push_back(entry{key, p});
+    for (size_t d = 0; d < sizeof(T); ++d) {
+      ++count[d][(key >> (d * 8)) & 0xff];
+    }
+  }
+  for (size_t d = 0; d < sizeof(T); ++d) {
+    size_t *c = count[d];
+    if (c[(a[0].key >> (d * 8)) & 0xff] == size_) {
+      continue;
     }
+    size_t sum = 0;
+    for (size_t k = 0; k < 256; ++k) {
+      const size_t n = c[k];
+      c[k] = sum;
+      sum += n;
+    }
+    for (const entry &e : a) {
+      b[c[(e.key >> (d * 8)) & 0xff]++] = e;
+    }
+    a.swap(b);
+  }
+  node_->prev->next = nullptr;
+  for (size_type i = 0; i + 1 < size_; ++i) {
+    a[i].node->next = a[i + 1].node;
   }
-  return result;
+  a[size_ - 1].node->next = nullptr;
+  link_chain(a[0].node);
 }
 
 // 重载比较操作符
@@ -0,0 +1,280 @@
+#ifndef MYTINYSTL_MULTIWAY_MERGE_H_
+#define MYTINYSTL_MULTIWAY_MERGE_H_
+
+// 这个头文件包含败者树 loser_tree，多路归并 multiway_merge，
+// 以及在多个有序序列中选出合并后第 r 个位置的 multiseq_select
+
+// notes:
+//
+// 败者树的每个内部节点记录在该处比赛中落败的来源及其当前元素的地址，
+// 根节点之上另存胜者。某个序列耗尽时把它去掉后重新建树，共 O(k^2)，
+// 与归并的元素个数无关。
+// 胜者输出一个元素后只需沿它的叶子到根的路径重赛一次，每层一次比较，
+// 每个元素 O(log k)。比较时序号较小的来源在相等时获胜，因此多路归并是稳定的：
+// 相等的元素按所在序列的先后、同一序列中按原来的先后输出
+
+#include <cstddef>
+#include <cstdint>
+
+#include "algo.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+/*****************************************************************************************/
+// loser_tree
+// 在 k 个来源之间比赛，每个来源提供一个指向当前元素的指针。
+// 先用 set 给出各来源的当前元素再 build，之后每次取走胜者的元素后
+// 用 replace_top 给出该来源的下一个元素。树中不表示已耗尽的来源，
+// 来源耗尽时由调用者去掉它后重新 build，这样重赛路径上没有额外的判断
+/*****************************************************************************************/
+template <class T, class Compared> class loser_tree {
+private:
+  struct node {
+    const T *key;
+    size_t src;
+  };
+
+  // nodes_[0] 为胜者，nodes_[1..k) 为各内部节点的败者，来源 i 对应第 k + i 个叶子
+  mystl::vector<node> nodes_;
+  mystl::vector<node> winners_; // build 时的临时空间
+  size_t k_;
+  Compared comp_;
+
+  // x 是否应排在 y 之前，相等时来源序号小的在前
+  bool beats(const node &x, const node &y) const {
+    // x.src < y.src 时为 !comp(*y, *x)，否则为 comp(*x, *y)，
+    // 先用异或掩码选出两个操作数再比较一次，避免在不可预测的条件上分支，
+    // 写成条件表达式时编译器常会把它变回分支
+    const bool xy = x.src < y.src;
+    const uintptr_t px = reinterpret_cast<uintptr_t>(x.key);
+    const uintptr_t py = reinterpret_cast<uintptr_t>(y.key);
+    const uintptr_t mask = (px ^ py) & (uintptr_t(0) - xy);
+    return comp_(*reinterpret_cast<const T *>(px ^ mask),
+                 *reinterpret_cast<const T *>(py ^ mask)) != xy;
+  }
+
+public:
+  // capacity 为来源个数的上限
+  loser_tree(size_t capacity, Compared comp) : k_(0), comp_(comp) {
+    nodes_.reserve(capacity);
+    winners_.reserve(2 * capacity);
+    for (size_t i = 0; i < 2 * capacity; ++i) {
+      winners_.push_back(node{nullptr, 0});
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+      nodes_.push_back(node{nullptr, 0});
+    }
+  }
+
+  size_t size() const noexcept { return k_; }
+
+  // 给出来源 src 的当前元素，在 build 之前调用
+  void set(size_t src, const T *key) { winners_[src] = node{key, src}; }
+
+  // 用前 k 个来源开始比赛，k 不能为 0
+  void build(size_t k) {
+    MYSTL_DEBUG(k > 0 && 2 * k <= winners_.size());
+    k_ = k;
+    // 叶子放在 winners_[k, 2k)，从后往前搬，不会覆盖还没搬的来源
+    for (size_t i = k; i > 0; --i) {
+      winners_[k + i - 1] = winners_[i - 1];
+    }
+    for (size_t n = k - 1; n > 0; --n) {
+      const node a = winners_[2 * n];
+      const node b = winners_[2 * n + 1];
+      const bool b_wins = beats(b, a);
+      nodes_[n] = b_wins ? a : b;
+      winners_[n] = b_wins ? b : a;
+    }
+    nodes_[0] = winners_[1];
+  }
+
+  // 胜者的来源及其当前元素
+  size_t top() const noexcept { return nodes_[0].src; }
+  const T *top_key() const noexcept { return nodes_[0].key; }
+
+  void replace_top(const T *key) {
+    // 节点的成员与 k_ 类型相同，写节点时编译器须假设 nodes_ 与 k_ 可能被改写，
+    // 所以先把它们读到局部变量中
+    node *nodes = nodes_.data();
+    node w{key, nodes[0].src};
+    for (size_t n = (k_ + w.src) / 2; n > 0; n /= 2) {
+      const node l = nodes[n];
+      const bool swap = beats(l, w);
+      nodes[n] = swap ? w : l;
+      w = swap ? l : w;
+    }
+    nodes[0] = w;
+  }
+};
+
+/*****************************************************************************************/
+// multiway_merge
+// 将多个有序序列合并到 result，返回一个迭代器指向输出结果的尾部
+// [rfirst, rlast) 中的每个元素是一个 mystl::pair，first 与 second 为一个序列的首尾
+/*****************************************************************************************/
+template <class RangeIter, class OutputIter, class Compared>
+OutputIter multiway_merge(RangeIter rfirst, RangeIter rlast, OutputIter result,
+                          Compared comp) {
+  typedef typename iterator_traits<RangeIter>::value_type range_type;
+  mystl::vector<range_type> cur;
+  for (; rfirst != rlast; ++rfirst) {
+    if ((*rfirst).first != (*rfirst).second) {
+      cur.push_back(*rfirst);
+    }
+  }
+  typedef typename iterator_traits<typename range_type::first_type>::value_type
+      value_type;
+  size_t active = cur.size();
+  if (active == 0) {
+    return result;
+  }
+  loser_tree<value_type, Compared> tree(active, comp);
+  while (active > 2) {
+    for (size_t i = 0; i < active; ++i) {
+      tree.set(i, mystl::address_of(*cur[i].first));
+    }
+    tree.build(active);
+    while (true) {
+      auto &src = cur[tree.top()];
+      *result = *src.first;
+      ++result;
+      if (++src.first == src.second)
+        break;
+      tree.replace_top(mystl::address_of(*src.first));
+    }
+    // 去掉耗尽的序列，保持其余序列的先后，然后重新建树
+    for (size_t i = tree.top() + 1; i < active; ++i) {
+      cur[i - 1] = cur[i];
+    }
+    --active;
+  }
+  // 只剩两个或一个序列时直接合并或拷贝
+  if (active == 2) {
+    return mystl::merge(cur[0].first, cur[0].second, cur[1].first,
+                        cur[1].second, result, comp);
+  }
+  return mystl::copy(cur[0].first, cur[0].second, result);
+}
+
+template <class RangeIter, class OutputIter>
+OutputIter multiway_merge(RangeIter rfirst, RangeIter rlast,
+                          OutputIter result) {
+  return mystl::multiway_merge(
+      rfirst, rlast, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+/*****************************************************************************************/
+// multiseq_select
+// 对多个可随机访问的有序序列，求出合并后前 r 个元素在各序列中所占的长度，
+// 写入 split[0..k)。相等的元素按序列的先后排列，与 multiway_merge 的输出一致。
+// 每轮以各序列剩余区间中点的加权中位数为枢轴，统计比它小的元素个数后
+// 收缩所有区间，剩余区间的总长每轮至少减少四分之一
+/*****************************************************************************************/
+template <class RangeIter, class Compared>
+void multiseq_select(RangeIter rfirst, RangeIter rlast, size_t r,
+                     size_t *split, Compared comp) {
+  typedef typename iterator_traits<RangeIter>::value_type range_type;
+  typedef typename range_type::first_type Iter;
+  mystl::vector<range_type> seqs;
+  for (; rfirst != rlast; ++rfirst) {
+    seqs.push_back(*rfirst);
+  }
+  const size_t k = seqs.size();
+  // 合并后的前 r 个元素在第 j 个序列中占 [0, split[j])，lo/hi 为它的上下界
+  mystl::vector<size_t> lo;
+  mystl::vector<size_t> hi;
+  mystl::vector<size_t> count;
+  // 枢轴候选：序列号与中点位置
+  mystl::vector<mystl::pair<size_t, size_t>> mids;
+  for (size_t j = 0; j < k; ++j) {
+    lo.push_back(0);
+    hi.push_back(static_cast<size_t>(seqs[j].second - seqs[j].first));
+    count.push_back(0);
+  }
+  // (p, m) 处的元素是否排在 (q, n) 处的元素之前
+  auto before = [&](size_t p, size_t m, size_t q, size_t n) -> bool {
+    const auto &x = *(seqs[p].first + m);
+    const auto &y = *(seqs[q].first + n);
+    if (comp(x, y))
+      return true;
+    if (comp(y, x))
+      return false;
+    return p < q || (p == q && m < n);
+  };
+  while (true) {
+    size_t remain = 0;
+    mids.clear();
+    for (size_t j = 0; j < k; ++j) {
+      if (lo[j] < hi[j]) {
+        remain += hi[j] - lo[j];
+        mids.push_back(
+            mystl::pair<size_t, size_t>(j, lo[j] + (hi[j] - lo[j]) / 2));
+      }
+    }
+    if (remain == 0)
+      break;
+    // 加权中位数：按元素排序后，累计权重首次达到一半的中点
+    mystl::sort(mids.begin(), mids.end(),
+                [&](const mystl::pair<size_t, size_t> &a,
+                    const mystl::pair<size_t, size_t> &b) {
+                  return before(a.first, a.second, b.first, b.second);
+                });
+    size_t acc = 0;
+    size_t pick = 0;
+    for (; pick + 1 < mids.size(); ++pick) {
+      const size_t j = mids[pick].first;
+      acc += hi[j] - lo[j];
+      if (2 * acc >= remain)
+        break;
+    }
+    const size_t p = mids[pick].first;
+    const size_t m = mids[pick].second;
+    // 统计各序列剩余区间中排在枢轴之前的元素个数
+    size_t total = 0;
+    for (size_t j = 0; j < k; ++j) {
+      if (j == p) {
+        count[j] = m;
+      } else {
+        // 与枢轴相等的元素，序列号较小时排在枢轴之前
+        const Iter first = seqs[j].first;
+        const auto &pivot = *(seqs[p].first + m);
+        const Iter it =
+            j < p ? mystl::upper_bound(first + lo[j], first + hi[j], pivot,
+                                       comp)
+                  : mystl::lower_bound(first + lo[j], first + hi[j], pivot,
+                                       comp);
+        count[j] = static_cast<size_t>(it - first);
+      }
+      total += count[j];
+    }
+    if (total == r) {
+      for (size_t j = 0; j < k; ++j) {
+        lo[j] = hi[j] = count[j];
+      }
+      break;
+    }
+    if (total < r) {
+      for (size_t j = 0; j < k; ++j) {
+        lo[j] = count[j];
+      }
+      lo[p] = m + 1; // 枢轴本身也在前 r 个元素之中
+    } else {
+      for (size_t j = 0; j < k; ++j) {
+        hi[j] = count[j];
+      }
+    }
+  }
+  for (size_t j = 0; j < k; ++j) {
+    split[j] = lo[j];
+  }
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_MULTIWAY_MERGE_H_
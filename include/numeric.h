@@ -0,0 +1,682 @@
+#ifndef MYTINYSTL_NUMERIC_H_
+#define MYTINYSTL_NUMERIC_H_
+
+// 这个头文件包含了 mystl 的数值算法
+// 顺序版本: accumulate, adjacent_difference, inner_product, iota, partial_sum,
+//           reduce, transform_reduce, inclusive_scan, exclusive_scan
+// 后四个算法另有执行策略版本
+
+// notes:
+//
+// reduce / transform_reduce 要求二元操作满足结合律与交换律，执行策略版本会
+// 以任意顺序组合各元素。若 op 有 identity_element(op)，unseq 版本对算术类型
+// 使用多个以单位元为初值的累加器并行累加，便于编译器向量化。
+//
+// 并行扫描采用两遍分块算法：第一遍并行求出各块之和，顺序求出各块的初值后，
+// 第二遍并行在各块内扫描。扫描只要求二元操作满足结合律。
+
+#include <cstddef>
+#include <type_traits>
+
+#include "execution.h"
+#include "functional.h"
+#include "iterator.h"
+#include "parallel_algo.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace mystl {
+
+/*****************************************************************************************/
+// accumulate
+// 版本1：以初值 init 对每个元素进行累加
+// 版本2：以初值 init 对每个元素进行二元操作
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp>
+T accumulate_dispatch(InputIter first, InputIter last, T init,
+                      BinaryOp &binary_op, m_false_type) {
+  for (; first != last; ++first) {
+    init = binary_op(init, *first);
+  }
+  return init;
+}
+
+// 分段迭代器逐段累加，段内为指针上的循环
+template <class SegIter, class T, class BinaryOp>
+T accumulate_dispatch(SegIter first, SegIter last, T init,
+                      BinaryOp &binary_op, m_true_type) {
+  mystl::for_each_segment(first, last, [&](auto, auto f, auto l) {
+    init = mystl::accumulate_dispatch(f, l, mystl::move(init), binary_op,
+                                      m_false_type());
+    return false;
+  });
+  return init;
+}
+
+template <class InputIter, class T>
+T accumulate(InputIter first, InputIter last, T init) {
+  auto plus = [](const T &x, const auto &y) -> T { return x + y; };
+  return mystl::accumulate_dispatch(first, last, mystl::move(init), plus,
+                                    is_segmented_iterator<InputIter>());
+}
+
+template <class InputIter, class T, class BinaryOp>
+T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op) {
+  return mystl::accumulate_dispatch(first, last, mystl::move(init),
+                                    binary_op,
+                                    is_segmented_iterator<InputIter>());
+}
+
+/*****************************************************************************************/
+// adjacent_difference
+// 版本1：计算相邻元素的差值，结果保存到以 result 为起始的区间上
+// 版本2：自定义相邻元素的二元操作
+/*****************************************************************************************/
+template <class InputIter, class OutputIter>
+OutputIter adjacent_difference(InputIter first, InputIter last,
+                               OutputIter result) {
+  if (first == last) {
+    return result;
+  }
+  auto value = *first;
+  *result = value; // 记录第一个元素
+  while (++first != last) {
+    auto tmp = *first;
+    *++result = tmp - value;
+    value = tmp;
+  }
+  return ++result;
+}
+
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter adjacent_difference(InputIter first, InputIter last,
+                               OutputIter result, BinaryOp binary_op) {
+  if (first == last) {
+    return result;
+  }
+  auto value = *first;
+  *result = value;
+  while (++first != last) {
+    auto tmp = *first;
+    *++result = binary_op(tmp, value);
+    value = tmp;
+  }
+  return ++result;
+}
+
+/*****************************************************************************************/
+// inner_product
+// 版本1：以 init 为初值，计算两个区间的内积
+// 版本2：自定义 operator+ 和 operator*
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T>
+T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                T init) {
+  for (; first1 != last1; ++first1, ++first2) {
+    init = init + (*first1 * *first2);
+  }
+  return init;
+}
+
+template <class InputIter1, class InputIter2, class T, class BinaryOp1,
+          class BinaryOp2>
+T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                BinaryOp1 binary_op1, BinaryOp2 binary_op2) {
+  for (; first1 != last1; ++first1, ++first2) {
+    init = binary_op1(init, binary_op2(*first1, *first2));
+  }
+  return init;
+}
+
+/*****************************************************************************************/
+// iota
+// 填充[first, last)，以 value 为初值开始递增
+/*****************************************************************************************/
+template <class ForwardIter, class T>
+void iota(ForwardIter first, ForwardIter last, T value) {
+  while (first != last) {
+    *first++ = value;
+    ++value;
+  }
+}
+
+/*****************************************************************************************/
+// partial_sum
+// 版本1：计算局部累计求和，结果保存到以 result 为起始的区间上
+// 版本2：进行局部进行自定义二元操作
+/*****************************************************************************************/
+template <class InputIter, class OutputIter>
+OutputIter partial_sum(InputIter first, InputIter last, OutputIter result) {
+  if (first == last) {
+    return result;
+  }
+  auto value = *first;
+  *result = value;
+  while (++first != last) {
+    value = value + *first;
+    *++result = value;
+  }
+  return ++result;
+}
+
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter partial_sum(InputIter first, InputIter last, OutputIter result,
+                       BinaryOp binary_op) {
+  if (first == last) {
+    return result;
+  }
+  auto value = *first;
+  *result = value;
+  while (++first != last) {
+    value = binary_op(value, *first);
+    *++result = value;
+  }
+  return ++result;
+}
+
+/*****************************************************************************************/
+// reduce
+// 与 accumulate 相同，但允许以任意顺序组合元素
+// 版本1：以值初始化的 value_type 为初值累加
+// 版本2：以 init 为初值累加
+// 版本3：以 init 为初值进行二元操作
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp>
+T reduce(InputIter first, InputIter last, T init, BinaryOp binary_op) {
+  return mystl::accumulate(first, last, init, binary_op);
+}
+
+template <class InputIter, class T>
+T reduce(InputIter first, InputIter last, T init) {
+  return mystl::reduce(first, last, init, mystl::plus<T>());
+}
+
+template <class InputIter>
+typename iterator_traits<InputIter>::value_type reduce(InputIter first,
+                                                       InputIter last) {
+  typedef typename iterator_traits<InputIter>::value_type T;
+  return mystl::reduce(first, last, T(), mystl::plus<T>());
+}
+
+/*****************************************************************************************/
+// transform_reduce
+// 版本1：与 inner_product 相同，但允许以任意顺序组合元素
+// 版本2：自定义归约操作 reduce_op 与两个区间元素间的变换 transform_op
+// 版本3：对每个元素调用一元变换 transform_op 后以 reduce_op 归约
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T, class BinaryOp1,
+          class BinaryOp2>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                   T init, BinaryOp1 reduce_op, BinaryOp2 transform_op) {
+  return mystl::inner_product(first1, last1, first2, init, reduce_op,
+                              transform_op);
+}
+
+template <class InputIter1, class InputIter2, class T>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                   T init) {
+  return mystl::transform_reduce(first1, last1, first2, init, mystl::plus<T>(),
+                                 mystl::multiplies<T>());
+}
+
+template <class InputIter, class T, class BinaryOp, class UnaryOp>
+T transform_reduce(InputIter first, InputIter last, T init, BinaryOp reduce_op,
+                   UnaryOp transform_op) {
+  for (; first != last; ++first) {
+    init = reduce_op(init, transform_op(*first));
+  }
+  return init;
+}
+
+/*****************************************************************************************/
+// inclusive_scan
+// 与 partial_sum 相同，但只要求二元操作满足结合律
+// 版本1：累计求和
+// 版本2：自定义二元操作
+// 版本3：自定义二元操作，并以 init 为初值
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          BinaryOp binary_op) {
+  return mystl::partial_sum(first, last, result, binary_op);
+}
+
+template <class InputIter, class OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result) {
+  return mystl::partial_sum(first, last, result);
+}
+
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          BinaryOp binary_op, T init) {
+  for (; first != last; ++first, ++result) {
+    init = binary_op(init, *first);
+    *result = init;
+  }
+  return result;
+}
+
+/*****************************************************************************************/
+// exclusive_scan
+// 以 init 为初值的前缀扫描，第 i 个结果不包含第 i 个元素
+// 版本1：累计求和
+// 版本2：自定义二元操作
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class T, class BinaryOp>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          T init, BinaryOp binary_op) {
+  for (; first != last; ++first, ++result) {
+    auto value = *first; // 允许 result 与 first 相同
+    *result = init;
+    init = binary_op(init, value);
+  }
+  return result;
+}
+
+template <class InputIter, class OutputIter, class T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter result,
+                          T init) {
+  return mystl::exclusive_scan(first, last, result, init, mystl::plus<T>());
+}
+
+/*****************************************************************************************/
+// 执行策略版本的辅助函数
+/*****************************************************************************************/
+
+// unseq 归约时使用的累加器个数
+constexpr static size_t kReduceLanes = 8;
+
+// has_identity_element
+// 对二元操作 BinaryOp 能找到可以转换为 T 的 identity_element(op) 时为真
+template <class T, class BinaryOp, class = void>
+struct has_identity_element : public m_false_type {};
+
+template <class T, class BinaryOp>
+struct has_identity_element<
+    T, BinaryOp,
+    std::void_t<decltype(static_cast<T>(
+        identity_element(std::declval<BinaryOp &>())))>> : public m_true_type {};
+
+// 是否使用多累加器的向量化归约
+template <class T, class BinaryOp, class Unseq>
+using reduce_lanes_tag =
+    std::integral_constant<bool, Unseq::value && std::is_arithmetic<T>::value &&
+                                     has_identity_element<T, BinaryOp>::value>;
+
+// 所有迭代器都是随机访问迭代器时为 std::true_type
+template <class... Iters>
+using all_random_access_tag =
+    std::integral_constant<bool,
+                           (is_random_access_iterator<Iters>::value && ...)>;
+
+// 以下归约函数以下标访问元素，load(i) 返回第 i 个元素(或其变换结果)
+// reduce_chunk 要求 [first, last) 非空，结果不含初值
+template <class T, class Size, class BinaryOp, class Load>
+T reduce_chunk(Size first, Size last, BinaryOp &binary_op, Load &load,
+               std::true_type) {
+  T acc[kReduceLanes];
+  for (size_t j = 0; j < kReduceLanes; ++j) {
+    acc[j] = identity_element(binary_op);
+  }
+  const auto lanes = static_cast<Size>(kReduceLanes);
+  for (; last - first >= lanes; first += lanes) {
+    MYSTL_PRAGMA_SIMD
+    for (Size j = 0; j < lanes; ++j) {
+      acc[j] = binary_op(acc[j], load(first + j));
+    }
+  }
+  T result = acc[0];
+  for (size_t j = 1; j < kReduceLanes; ++j) {
+    result = binary_op(result, acc[j]);
+  }
+  for (; first < last; ++first) {
+    result = binary_op(result, load(first));
+  }
+  return result;
+}
+
+template <class T, class Size, class BinaryOp, class Load>
+T reduce_chunk(Size first, Size last, BinaryOp &binary_op, Load &load,
+               std::false_type) {
+  T result = load(first);
+  for (++first; first < last; ++first) {
+    result = binary_op(result, load(first));
+  }
+  return result;
+}
+
+// 对 [0, n) 做归约
+template <class T, class Size, class BinaryOp, class Load, class Unseq>
+T reduce_index(Size n, T init, BinaryOp &binary_op, Load &load,
+               std::false_type, Unseq) {
+  if (n == 0) {
+    return init;
+  }
+  return binary_op(init, mystl::reduce_chunk<T>(
+                             Size(0), n, binary_op, load,
+                             reduce_lanes_tag<T, BinaryOp, Unseq>()));
+}
+
+template <class T, class Size, class BinaryOp, class Load, class Unseq>
+T reduce_index(Size n, T init, BinaryOp &binary_op, Load &load,
+               std::true_type, Unseq unseq) {
+  const auto block = static_cast<Size>(
+      mystl::parallel_grain(static_cast<size_t>(n)));
+  if (n <= block) {
+    return mystl::reduce_index(n, init, binary_op, load, std::false_type(),
+                               unseq);
+  }
+  const Size nblocks = (n + block - 1) / block;
+  mystl::vector<T> sums;
+  sums.reserve(static_cast<size_t>(nblocks));
+  for (Size b = 0; b < nblocks; ++b) {
+    sums.emplace_back(init);
+  }
+  mystl::default_thread_pool().parallel_for(
+      Size(0), nblocks, 1, [&](Size bf, Size bl) {
+        for (; bf < bl; ++bf) {
+          const Size l = n - bf * block > block ? (bf + 1) * block : n;
+          sums[bf] = mystl::reduce_chunk<T>(
+              bf * block, l, binary_op, load,
+              reduce_lanes_tag<T, BinaryOp, Unseq>());
+        }
+      });
+  for (Size b = 0; b < nblocks; ++b) {
+    init = binary_op(init, sums[b]);
+  }
+  return init;
+}
+
+// 以 carry 为初值在一块内做包含(inclusive)或不包含(exclusive)的扫描
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp>
+void scan_block(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                T carry, BinaryOp &binary_op, std::true_type) {
+  for (; first != last; ++first, ++result) {
+    carry = binary_op(carry, *first);
+    *result = carry;
+  }
+}
+
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp>
+void scan_block(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                T carry, BinaryOp &binary_op, std::false_type) {
+  for (; first != last; ++first, ++result) {
+    auto value = *first;
+    *result = carry;
+    carry = binary_op(carry, value);
+  }
+}
+
+// 两遍分块的并行扫描，init 为空指针时表示没有初值(只用于 inclusive)
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp,
+          class Inclusive, class Unseq>
+RandomIter2 par_scan(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                     const T *init, BinaryOp &binary_op, Inclusive inclusive,
+                     Unseq) {
+  typedef typename iterator_traits<RandomIter1>::difference_type Distance;
+  const Distance n = last - first;
+  const auto block =
+      static_cast<Distance>(mystl::parallel_grain(static_cast<size_t>(n)));
+  if (n <= block) {
+    if (init == nullptr) {
+      return mystl::partial_sum(first, last, result, binary_op);
+    }
+    mystl::scan_block(first, last, result, *init, binary_op, inclusive);
+    return result + n;
+  }
+  const Distance nblocks = (n + block - 1) / block;
+  auto load = [first](Distance i) { return first[i]; };
+  mystl::vector<T> sums;
+  sums.reserve(static_cast<size_t>(nblocks));
+  for (Distance b = 0; b < nblocks; ++b) {
+    sums.emplace_back(first[b * block]);
+  }
+  auto &pool = mystl::default_thread_pool();
+  // 第一遍：求出除最后一块外各块之和
+  pool.parallel_for(Distance(0), nblocks - 1, 1, [&](Distance bf, Distance bl) {
+    for (; bf < bl; ++bf) {
+      sums[bf] = mystl::reduce_chunk<T>(bf * block, (bf + 1) * block,
+                                        binary_op, load,
+                                        reduce_lanes_tag<T, BinaryOp, Unseq>());
+    }
+  });
+  // 把各块之和转换为各块的初值，没有初值时第一块不需要初值
+  Distance b = init == nullptr ? 1 : 0;
+  T carry = init == nullptr ? sums[0] : *init;
+  for (; b < nblocks; ++b) {
+    T sum = sums[b];
+    sums[b] = carry;
+    if (b + 1 < nblocks) {
+      carry = binary_op(carry, sum);
+    }
+  }
+  // 第二遍：各块以自己的初值扫描
+  pool.parallel_for(Distance(0), nblocks, 1, [&](Distance bf, Distance bl) {
+    for (; bf < bl; ++bf) {
+      const Distance f = bf * block;
+      const Distance l = n - f > block ? f + block : n;
+      if (bf == 0 && init == nullptr) {
+        mystl::partial_sum(first, first + l, result, binary_op);
+      } else {
+        mystl::scan_block(first + f, first + l, result + f, sums[bf], binary_op,
+                          inclusive);
+      }
+    }
+  });
+  return result + n;
+}
+
+/*****************************************************************************************/
+// reduce
+// 执行策略版本
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp, class Par, class Unseq>
+T reduce_policy(InputIter first, InputIter last, T init, BinaryOp &binary_op,
+                Par, Unseq, std::false_type) {
+  return mystl::reduce(first, last, init, binary_op);
+}
+
+template <class RandomIter, class T, class BinaryOp, class Par, class Unseq>
+T reduce_policy(RandomIter first, RandomIter last, T init, BinaryOp &binary_op,
+                Par par, Unseq unseq, std::true_type) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  auto load = [first](Distance i) { return first[i]; };
+  return mystl::reduce_index(last - first, init, binary_op, load, par, unseq);
+}
+
+template <class ExecutionPolicy, class ForwardIter, class T, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last, T init,
+       BinaryOp binary_op) {
+  return mystl::reduce_policy(first, last, init, binary_op,
+                              policy_parallel(policy),
+                              policy_unsequenced(policy),
+                              all_random_access_tag<ForwardIter>());
+}
+
+template <class ExecutionPolicy, class ForwardIter, class T>
+enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last, T init) {
+  return mystl::reduce(policy, first, last, init, mystl::plus<T>());
+}
+
+template <class ExecutionPolicy, class ForwardIter>
+enable_if_execution_policy<ExecutionPolicy,
+                           typename iterator_traits<ForwardIter>::value_type>
+reduce(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last) {
+  typedef typename iterator_traits<ForwardIter>::value_type T;
+  return mystl::reduce(policy, first, last, T(), mystl::plus<T>());
+}
+
+/*****************************************************************************************/
+// transform_reduce
+// 执行策略版本
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T, class BinaryOp1,
+          class BinaryOp2, class Par, class Unseq>
+T transform_reduce_policy(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, T init, BinaryOp1 &reduce_op,
+                          BinaryOp2 &transform_op, Par, Unseq,
+                          std::false_type) {
+  return mystl::transform_reduce(first1, last1, first2, init, reduce_op,
+                                 transform_op);
+}
+
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp1,
+          class BinaryOp2, class Par, class Unseq>
+T transform_reduce_policy(RandomIter1 first1, RandomIter1 last1,
+                          RandomIter2 first2, T init, BinaryOp1 &reduce_op,
+                          BinaryOp2 &transform_op, Par par, Unseq unseq,
+                          std::true_type) {
+  typedef typename iterator_traits<RandomIter1>::difference_type Distance;
+  auto load = [first1, first2, &transform_op](Distance i) {
+    return transform_op(first1[i], first2[i]);
+  };
+  return mystl::reduce_index(last1 - first1, init, reduce_op, load, par,
+                             unseq);
+}
+
+template <class ExecutionPolicy, class ForwardIter1, class ForwardIter2,
+          class T, class BinaryOp1, class BinaryOp2>
+enable_if_execution_policy<ExecutionPolicy, T>
+transform_reduce(ExecutionPolicy &&policy, ForwardIter1 first1,
+                 ForwardIter1 last1, ForwardIter2 first2, T init,
+                 BinaryOp1 reduce_op, BinaryOp2 transform_op) {
+  return mystl::transform_reduce_policy(
+      first1, last1, first2, init, reduce_op, transform_op,
+      policy_parallel(policy), policy_unsequenced(policy),
+      all_random_access_tag<ForwardIter1, ForwardIter2>());
+}
+
+template <class ExecutionPolicy, class ForwardIter1, class ForwardIter2,
+          class T>
+enable_if_execution_policy<ExecutionPolicy, T>
+transform_reduce(ExecutionPolicy &&policy, ForwardIter1 first1,
+                 ForwardIter1 last1, ForwardIter2 first2, T init) {
+  return mystl::transform_reduce(policy, first1, last1, first2, init,
+                                 mystl::plus<T>(), mystl::multiplies<T>());
+}
+
+template <class InputIter, class T, class BinaryOp, class UnaryOp, class Par,
+          class Unseq>
+T transform_reduce_policy(InputIter first, InputIter last, T init,
+                          BinaryOp &reduce_op, UnaryOp &transform_op, Par,
+                          Unseq, std::false_type) {
+  return mystl::transform_reduce(first, last, init, reduce_op, transform_op);
+}
+
+template <class RandomIter, class T, class BinaryOp, class UnaryOp, class Par,
+          class Unseq>
+T transform_reduce_policy(RandomIter first, RandomIter last, T init,
+                          BinaryOp &reduce_op, UnaryOp &transform_op, Par par,
+                          Unseq unseq, std::true_type) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  auto load = [first, &transform_op](Distance i) {
+    return transform_op(first[i]);
+  };
+  return mystl::reduce_index(last - first, init, reduce_op, load, par, unseq);
+}
+
+template <class ExecutionPolicy, class ForwardIter, class T, class BinaryOp,
+          class UnaryOp>
+enable_if_execution_policy<ExecutionPolicy, T>
+transform_reduce(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+                 T init, BinaryOp reduce_op, UnaryOp transform_op) {
+  return mystl::transform_reduce_policy(
+      first, last, init, reduce_op, transform_op, policy_parallel(policy),
+      policy_unsequenced(policy), all_random_access_tag<ForwardIter>());
+}
+
+/*****************************************************************************************/
+// inclusive_scan / exclusive_scan
+// 执行策略版本，只有 par 与 par_unseq 会并行，unseq 只作用于第一遍的分块求和
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class T, class BinaryOp,
+          class Inclusive, class Par, class Unseq>
+OutputIter scan_policy(InputIter first, InputIter last, OutputIter result,
+                       const T *init, BinaryOp &binary_op, Inclusive, Par,
+                       Unseq, std::false_type) {
+  if (init == nullptr) {
+    return mystl::partial_sum(first, last, result, binary_op);
+  }
+  return Inclusive::value
+             ? mystl::inclusive_scan(first, last, result, binary_op, *init)
+             : mystl::exclusive_scan(first, last, result, *init, binary_op);
+}
+
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp,
+          class Inclusive, class Unseq>
+RandomIter2 scan_policy(RandomIter1 first, RandomIter1 last,
+                        RandomIter2 result, const T *init, BinaryOp &binary_op,
+                        Inclusive inclusive, std::false_type par, Unseq unseq,
+                        std::true_type) {
+  return mystl::scan_policy(first, last, result, init, binary_op, inclusive,
+                            par, unseq, std::false_type());
+}
+
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp,
+          class Inclusive, class Unseq>
+RandomIter2 scan_policy(RandomIter1 first, RandomIter1 last,
+                        RandomIter2 result, const T *init, BinaryOp &binary_op,
+                        Inclusive inclusive, std::true_type, Unseq unseq,
+                        std::true_type) {
+  return mystl::par_scan(first, last, result, init, binary_op, inclusive,
+                         unseq);
+}
+
+template <class ExecutionPolicy, class ForwardIter1, class ForwardIter2,
+          class BinaryOp, class T>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter2>
+inclusive_scan(ExecutionPolicy &&policy, ForwardIter1 first,
+               ForwardIter1 last, ForwardIter2 result, BinaryOp binary_op,
+               T init) {
+  return mystl::scan_policy(first, last, result, &init, binary_op,
+                            std::true_type(), policy_parallel(policy),
+                            policy_unsequenced(policy),
+                            all_random_access_tag<ForwardIter1, ForwardIter2>());
+}
+
+template <class ExecutionPolicy, class ForwardIter1, class ForwardIter2,
+          class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter2>
+inclusive_scan(ExecutionPolicy &&policy, ForwardIter1 first,
+               ForwardIter1 last, ForwardIter2 result, BinaryOp binary_op) {
+  typedef typename iterator_traits<ForwardIter1>::value_type T;
+  const T *init = nullptr;
+  return mystl::scan_policy(first, last, result, init, binary_op,
+                            std::true_type(), policy_parallel(policy),
+                            policy_unsequenced(policy),
+                            all_random_access_tag<ForwardIter1, ForwardIter2>());
+}
+
+template <class ExecutionPolicy, class ForwardIter1, class ForwardIter2>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter2>
+inclusive_scan(ExecutionPolicy &&policy, ForwardIter1 first,
+               ForwardIter1 last, ForwardIter2 result) {
+  typedef typename iterator_traits<ForwardIter1>::value_type T;
+  return mystl::inclusive_scan(policy, first, last, result, mystl::plus<T>());
+}
+
+template <class ExecutionPolicy, class ForwardIter1, class ForwardIter2,
+          class T, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter2>
+exclusive_scan(ExecutionPolicy &&policy, ForwardIter1 first,
+               ForwardIter1 last, ForwardIter2 result, T init,
+               BinaryOp binary_op) {
+  return mystl::scan_policy(first, last, result, &init, binary_op,
+                            std::false_type(), policy_parallel(policy),
+                            policy_unsequenced(policy),
+                            all_random_access_tag<ForwardIter1, ForwardIter2>());
+}
+
+template <class ExecutionPolicy, class ForwardIter1, class ForwardIter2,
+          class T>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter2>
+exclusive_scan(ExecutionPolicy &&policy, ForwardIter1 first,
+               ForwardIter1 last, ForwardIter2 result, T init) {
+  return mystl::exclusive_scan(policy, first, last, result, init,
+                               mystl::plus<T>());
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_NUMERIC_H_
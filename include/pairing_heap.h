@@ -0,0 +1,328 @@
+#ifndef MYTINYSTL_PAIRING_HEAP_H_
+#define MYTINYSTL_PAIRING_HEAP_H_
+
+// 这个头文件包含一个模板类 pairing_heap
+// pairing_heap : 配对堆，可以通过句柄修改或删除堆中的任意元素
+
+// notes:
+//
+// 所有节点放在一个 mystl::vector 组成的节点池中，节点之间用下标相连，
+// 句柄即节点的下标；被删除的节点进入空闲链表供之后的 push 复用，
+// 因此除了节点池扩容外不会为单个元素申请内存。
+// 每个节点记录第一个子节点、下一个兄弟节点，以及 prev：
+// 是第一个子节点时 prev 为父节点，否则为前一个兄弟节点。
+// 元素放在 union 中手动管理生命周期，节点释放时即析构元素，复用时再构造，
+// 不会让已删除的元素一直占用资源。
+// 与 priority_queue 相同，比较函数为 less 时堆顶为最大的元素；
+// decrease_key 把元素改为优先级不低于原值的新值，均摊 O(log n) 以内，
+// 实际接近常数时间
+
+#include <cstddef>
+
+#include "construct.h"
+#include "exceptdef.h"
+#include "functional.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+template <class T, class Compare = mystl::less<T>> class pairing_heap {
+public:
+  typedef T value_type;
+  typedef Compare value_compare;
+  typedef size_t size_type;
+  typedef size_t handle_type;
+  typedef const T &const_reference;
+
+private:
+  static constexpr size_type kNil = static_cast<size_type>(-1);
+  static constexpr size_type kFreed = static_cast<size_type>(-2);
+
+  struct node {
+    union {
+      T value; // prev 为 kFreed 时未构造
+    };
+    size_type child;
+    size_type sibling;
+    size_type prev; // 已释放的节点为 kFreed
+
+    explicit node(T &&v)
+        : value(mystl::move(v)), child(kNil), sibling(kNil), prev(kNil) {}
+
+    node(const node &rhs)
+        : child(rhs.child), sibling(rhs.sibling), prev(kFreed) {
+      if (rhs.prev != kFreed) {
+        mystl::construct(&value, rhs.value);
+      }
+      prev = rhs.prev;
+    }
+
+    node(node &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : child(rhs.child), sibling(rhs.sibling), prev(kFreed) {
+      if (rhs.prev != kFreed) {
+        mystl::construct(&value, mystl::move(rhs.value));
+      }
+      prev = rhs.prev;
+    }
+
+    node &operator=(const node &rhs) {
+      if (this != &rhs) {
+        reset();
+        if (rhs.prev != kFreed) {
+          mystl::construct(&value, rhs.value);
+        }
+        child = rhs.child;
+        sibling = rhs.sibling;
+        prev = rhs.prev;
+      }
+      return *this;
+    }
+
+    node &operator=(node &&rhs) {
+      if (this != &rhs) {
+        reset();
+        if (rhs.prev != kFreed) {
+          mystl::construct(&value, mystl::move(rhs.value));
+        }
+        child = rhs.child;
+        sibling = rhs.sibling;
+        prev = rhs.prev;
+      }
+      return *this;
+    }
+
+    ~node() { reset(); }
+
+    // 析构元素，节点变为已释放
+    void reset() noexcept {
+      if (prev != kFreed) {
+        mystl::destroy(&value);
+        prev = kFreed;
+      }
+    }
+  };
+
+  mystl::vector<node> pool_;        // 节点池，下标即句柄
+  mystl::vector<size_type> free_;   // 空闲的节点
+  mystl::vector<size_type> pairs_;  // merge_pairs 使用的临时空间
+  size_type root_;
+  size_type size_;
+  value_compare comp_;
+
+public:
+  pairing_heap() : root_(kNil), size_(0), comp_() {}
+  explicit pairing_heap(const Compare &comp)
+      : root_(kNil), size_(0), comp_(comp) {}
+
+  // 容量相关操作
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  void reserve(size_type n) { pool_.reserve(n); }
+
+  // 访问元素相关操作
+  const_reference top() const {
+    MYSTL_DEBUG(!empty());
+    return pool_[root_].value;
+  }
+
+  handle_type top_handle() const {
+    MYSTL_DEBUG(!empty());
+    return root_;
+  }
+
+  bool contains(handle_type h) const noexcept {
+    return h < pool_.size() && pool_[h].prev != kFreed;
+  }
+
+  const_reference value(handle_type h) const {
+    MYSTL_DEBUG(contains(h));
+    return pool_[h].value;
+  }
+
+  // 修改容器相关操作
+  handle_type push(const value_type &value) {
+    return push_aux(value_type(value));
+  }
+
+  handle_type push(value_type &&value) { return push_aux(mystl::move(value)); }
+
+  void pop() {
+    MYSTL_DEBUG(!empty());
+    const size_type h = root_;
+    root_ = merge_pairs(pool_[h].child);
+    release(h);
+  }
+
+  // value 的优先级不能低于原值
+  void decrease_key(handle_type h, const value_type &value) {
+    MYSTL_DEBUG(contains(h) && !comp_(value, pool_[h].value));
+    pool_[h].value = value;
+    if (h != root_) {
+      cut(h);
+      root_ = link(root_, h);
+    }
+  }
+
+  void update(handle_type h, const value_type &value);
+
+  void erase(handle_type h);
+
+  void clear() {
+    pool_.clear();
+    free_.clear();
+    root_ = kNil;
+    size_ = 0;
+  }
+
+  void swap(pairing_heap &rhs) noexcept {
+    pool_.swap(rhs.pool_);
+    free_.swap(rhs.free_);
+    pairs_.swap(rhs.pairs_);
+    mystl::swap(root_, rhs.root_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+private:
+  handle_type push_aux(value_type &&value);
+  size_type link(size_type a, size_type b);
+  void cut(size_type h);
+  size_type merge_pairs(size_type first);
+
+  void release(size_type h) {
+    pool_[h].reset();
+    free_.push_back(h);
+    --size_;
+  }
+};
+
+/*****************************************************************************************/
+// helper function
+
+template <class T, class Compare>
+typename pairing_heap<T, Compare>::handle_type
+pairing_heap<T, Compare>::push_aux(value_type &&value) {
+  size_type h;
+  if (!free_.empty()) {
+    h = free_.back();
+    node &n = pool_[h];
+    mystl::construct(&n.value, mystl::move(value));
+    n.child = n.sibling = n.prev = kNil;
+    free_.pop_back();
+  } else {
+    h = pool_.size();
+    pool_.push_back(node(mystl::move(value)));
+  }
+  root_ = root_ == kNil ? h : link(root_, h);
+  ++size_;
+  return h;
+}
+
+// 合并两棵树 a 和 b，优先级较低的根成为另一个根的第一个子节点
+template <class T, class Compare>
+typename pairing_heap<T, Compare>::size_type
+pairing_heap<T, Compare>::link(size_type a, size_type b) {
+  if (comp_(pool_[a].value, pool_[b].value)) {
+    mystl::swap(a, b);
+  }
+  node &na = pool_[a];
+  node &nb = pool_[b];
+  nb.sibling = na.child;
+  if (na.child != kNil) {
+    pool_[na.child].prev = b;
+  }
+  nb.prev = a;
+  na.child = b;
+  return a;
+}
+
+// 把以 h 为根的子树从所在的兄弟链表中摘下
+template <class T, class Compare>
+void pairing_heap<T, Compare>::cut(size_type h) {
+  node &n = pool_[h];
+  if (pool_[n.prev].child == h) {
+    pool_[n.prev].child = n.sibling;
+  } else {
+    pool_[n.prev].sibling = n.sibling;
+  }
+  if (n.sibling != kNil) {
+    pool_[n.sibling].prev = n.prev;
+  }
+  n.prev = n.sibling = kNil;
+}
+
+// 两趟合并 first 开始的兄弟链表：先从左到右两两合并，再从右到左依次合并
+template <class T, class Compare>
+typename pairing_heap<T, Compare>::size_type
+pairing_heap<T, Compare>::merge_pairs(size_type first) {
+  if (first == kNil) {
+    return kNil;
+  }
+  pairs_.clear();
+  while (first != kNil) {
+    const size_type a = first;
+    const size_type b = pool_[a].sibling;
+    pool_[a].prev = pool_[a].sibling = kNil;
+    if (b == kNil) {
+      pairs_.push_back(a);
+      break;
+    }
+    first = pool_[b].sibling;
+    pool_[b].prev = pool_[b].sibling = kNil;
+    pairs_.push_back(link(a, b));
+  }
+  size_type r = pairs_.back();
+  for (size_type i = pairs_.size() - 1; i-- > 0;) {
+    r = link(pairs_[i], r);
+  }
+  return r;
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::update(handle_type h, const value_type &value) {
+  MYSTL_DEBUG(contains(h));
+  if (!comp_(value, pool_[h].value)) {
+    decrease_key(h, value);
+    return;
+  }
+  // 优先级降低：子树中的元素可能比它更优先，先把子节点并回堆中
+  if (h == root_) {
+    root_ = merge_pairs(pool_[h].child);
+  } else {
+    cut(h);
+    const size_type sub = merge_pairs(pool_[h].child);
+    if (sub != kNil) {
+      root_ = link(root_, sub);
+    }
+  }
+  node &n = pool_[h];
+  n.child = kNil;
+  n.value = value;
+  root_ = root_ == kNil ? h : link(root_, h);
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::erase(handle_type h) {
+  MYSTL_DEBUG(contains(h));
+  if (h == root_) {
+    pop();
+    return;
+  }
+  cut(h);
+  const size_type sub = merge_pairs(pool_[h].child);
+  if (sub != kNil) {
+    root_ = link(root_, sub);
+  }
+  release(h);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare>
+void swap(pairing_heap<T, Compare> &lhs,
+          pairing_heap<T, Compare> &rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_PAIRING_HEAP_H_
@@ -0,0 +1,1136 @@
+#ifndef MYTINYSTL_PARALLEL_ALGO_H_
+#define MYTINYSTL_PARALLEL_ALGO_H_
+
+// 这个头文件包含 algo.h 中部分算法的执行策略(execution policy)重载版本
+// 第一个参数为 mystl::execution::seq/unseq/par/par_unseq 之一
+// 只有随机访问迭代器会被并行或向量化处理，其余迭代器退化为顺序版本
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "algo.h"
+#include "execution.h"
+#include "iterator.h"
+#include "memory.h"
+#include "multiway_merge.h"
+#include "random.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+namespace mystl {
+
+// 长度不超过该值的区间不再划分，直接在当前线程处理
+constexpr static size_t kParallelGrainSize = 4096;
+// 查找类算法在子区间内每处理这么多元素检查一次是否可以提前结束
+constexpr static size_t kParallelCancelBlock = 1024;
+// unseq 版本的查找每次用无分支的方式检查这么多元素
+constexpr static size_t kUnseqBlockSize = 32;
+
+// 根据默认线程池给出并行划分的粒度
+inline size_t parallel_grain(size_t n) {
+  const size_t grain = mystl::default_thread_pool().default_grain(n);
+  return grain < kParallelGrainSize ? kParallelGrainSize : grain;
+}
+
+/*****************************************************************************************/
+// find_if / find_if_not / find
+// 执行策略版本，par 下各线程发现匹配后会让位于其后的子区间提前结束
+/*****************************************************************************************/
+// 向量化的查找：先无分支地判断一块元素中是否存在匹配，再在该块内定位
+template <class RandomIter, class UnaryPredicate>
+RandomIter unseq_find_if(RandomIter first, RandomIter last,
+                         UnaryPredicate unary_pred) {
+  const auto block = static_cast<ptrdiff_t>(kUnseqBlockSize);
+  while (last - first >= block) {
+    bool hit = false;
+    MYSTL_PRAGMA_SIMD
+    for (ptrdiff_t i = 0; i < block; ++i) {
+      hit |= static_cast<bool>(unary_pred(first[i]));
+    }
+    if (hit) {
+      break;
+    }
+    first += block;
+  }
+  return mystl::find_if(first, last, unary_pred);
+}
+
+template <class RandomIter, class UnaryPredicate>
+RandomIter find_if_chunk(RandomIter first, RandomIter last,
+                         UnaryPredicate &unary_pred, std::true_type) {
+  return mystl::unseq_find_if(first, last, unary_pred);
+}
+
+template <class RandomIter, class UnaryPredicate>
+RandomIter find_if_chunk(RandomIter first, RandomIter last,
+                         UnaryPredicate &unary_pred, std::false_type) {
+  return mystl::find_if(first, last, unary_pred);
+}
+
+// 并行查找，found 记录目前找到的最靠前的位置
+template <class RandomIter, class UnaryPredicate, class Unseq>
+RandomIter par_find_if(RandomIter first, RandomIter last,
+                       UnaryPredicate &unary_pred, Unseq unseq) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance n = last - first;
+  if (static_cast<size_t>(n) <= kParallelGrainSize) {
+    return mystl::find_if_chunk(first, last, unary_pred, unseq);
+  }
+  std::atomic<Distance> found(n);
+  const auto block = static_cast<Distance>(kParallelCancelBlock);
+  mystl::default_thread_pool().parallel_for(
+      first, last, mystl::parallel_grain(n), [&](RandomIter f, RandomIter l) {
+        while (f < l) {
+          // 前面的子区间已经找到，本区间的结果不会再被采用
+          if (found.load(std::memory_order_relaxed) < f - first) {
+            return;
+          }
+          RandomIter bl = l - f > block ? f + block : l;
+          RandomIter pos = mystl::find_if_chunk(f, bl, unary_pred, unseq);
+          if (pos != bl) {
+            const Distance i = pos - first;
+            Distance cur = found.load(std::memory_order_relaxed);
+            while (i < cur && !found.compare_exchange_weak(cur, i)) {
+            }
+            return;
+          }
+          f = bl;
+        }
+      });
+  return first + found.load();
+}
+
+// find_if_policy 的 input_iterator_tag 版本
+template <class InputIter, class UnaryPredicate, class Par, class Unseq>
+InputIter find_if_policy(InputIter first, InputIter last,
+                         UnaryPredicate &unary_pred, Par, Unseq,
+                         mystl::input_iterator_tag) {
+  return mystl::find_if(first, last, unary_pred);
+}
+
+// find_if_policy 的 random_access_iterator_tag 版本
+template <class RandomIter, class UnaryPredicate, class Unseq>
+RandomIter find_if_policy(RandomIter first, RandomIter last,
+                          UnaryPredicate &unary_pred, std::false_type,
+                          Unseq unseq, mystl::random_access_iterator_tag) {
+  return mystl::find_if_chunk(first, last, unary_pred, unseq);
+}
+
+template <class RandomIter, class UnaryPredicate, class Unseq>
+RandomIter find_if_policy(RandomIter first, RandomIter last,
+                          UnaryPredicate &unary_pred, std::true_type,
+                          Unseq unseq, mystl::random_access_iterator_tag) {
+  return mystl::par_find_if(first, last, unary_pred, unseq);
+}
+
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+find_if(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+        UnaryPredicate unary_pred) {
+  return mystl::find_if_policy(first, last, unary_pred, policy_parallel(policy),
+                               policy_unsequenced(policy),
+                               iterator_category(first));
+}
+
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+find_if_not(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+            UnaryPredicate unary_pred) {
+  auto pred = [&unary_pred](const auto &x) -> bool { return !unary_pred(x); };
+  return mystl::find_if_policy(first, last, pred, policy_parallel(policy),
+                               policy_unsequenced(policy),
+                               iterator_category(first));
+}
+
+template <class ExecutionPolicy, class ForwardIter, class T>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+find(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+     const T &value) {
+  auto pred = [&value](const auto &x) -> bool { return x == value; };
+  return mystl::find_if_policy(first, last, pred, policy_parallel(policy),
+                               policy_unsequenced(policy),
+                               iterator_category(first));
+}
+
+/*****************************************************************************************/
+// all_of / any_of / none_of
+// 执行策略版本，转换为 find_if / find_if_not，可以提前结束
+/*****************************************************************************************/
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, bool>
+all_of(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+       UnaryPredicate unary_pred) {
+  return mystl::find_if_not(policy, first, last, unary_pred) == last;
+}
+
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, bool>
+any_of(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+       UnaryPredicate unary_pred) {
+  return mystl::find_if(policy, first, last, unary_pred) != last;
+}
+
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, bool>
+none_of(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+        UnaryPredicate unary_pred) {
+  return mystl::find_if(policy, first, last, unary_pred) == last;
+}
+
+/*****************************************************************************************/
+// count_if / count
+// 执行策略版本，各子区间分别计数后累加
+/*****************************************************************************************/
+template <class RandomIter, class UnaryPredicate>
+size_t count_if_chunk(RandomIter first, RandomIter last,
+                      UnaryPredicate &unary_pred, std::true_type) {
+  const auto len = last - first;
+  size_t n = 0;
+  MYSTL_PRAGMA_SIMD
+  for (decltype(last - first) i = 0; i < len; ++i) {
+    n += unary_pred(first[i]) ? 1 : 0;
+  }
+  return n;
+}
+
+template <class RandomIter, class UnaryPredicate>
+size_t count_if_chunk(RandomIter first, RandomIter last,
+                      UnaryPredicate &unary_pred, std::false_type) {
+  return mystl::count_if(first, last, unary_pred);
+}
+
+// count_if_policy 的 input_iterator_tag 版本
+template <class InputIter, class UnaryPredicate, class Par, class Unseq>
+size_t count_if_policy(InputIter first, InputIter last,
+                       UnaryPredicate &unary_pred, Par, Unseq,
+                       mystl::input_iterator_tag) {
+  return mystl::count_if(first, last, unary_pred);
+}
+
+// count_if_policy 的 random_access_iterator_tag 版本
+template <class RandomIter, class UnaryPredicate, class Unseq>
+size_t count_if_policy(RandomIter first, RandomIter last,
+                       UnaryPredicate &unary_pred, std::false_type,
+                       Unseq unseq, mystl::random_access_iterator_tag) {
+  return mystl::count_if_chunk(first, last, unary_pred, unseq);
+}
+
+template <class RandomIter, class UnaryPredicate, class Unseq>
+size_t count_if_policy(RandomIter first, RandomIter last,
+                       UnaryPredicate &unary_pred, std::true_type,
+                       Unseq unseq, mystl::random_access_iterator_tag) {
+  const auto n = static_cast<size_t>(last - first);
+  if (n <= kParallelGrainSize) {
+    return mystl::count_if_chunk(first, last, unary_pred, unseq);
+  }
+  std::atomic<size_t> total(0);
+  mystl::default_thread_pool().parallel_for(
+      first, last, mystl::parallel_grain(n), [&](RandomIter f, RandomIter l) {
+        total.fetch_add(mystl::count_if_chunk(f, l, unary_pred, unseq),
+                        std::memory_order_relaxed);
+      });
+  return total.load();
+}
+
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, size_t>
+count_if(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+         UnaryPredicate unary_pred) {
+  return mystl::count_if_policy(first, last, unary_pred,
+                                policy_parallel(policy),
+                                policy_unsequenced(policy),
+                                iterator_category(first));
+}
+
+template <class ExecutionPolicy, class ForwardIter, class T>
+enable_if_execution_policy<ExecutionPolicy, size_t>
+count(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+      const T &value) {
+  auto pred = [&value](const auto &x) -> bool { return x == value; };
+  return mystl::count_if_policy(first, last, pred, policy_parallel(policy),
+                                policy_unsequenced(policy),
+                                iterator_category(first));
+}
+
+/*****************************************************************************************/
+// for_each
+// 执行策略版本，各元素的处理顺序不确定，f 需要能被多个线程同时调用
+/*****************************************************************************************/
+template <class RandomIter, class Function>
+void for_each_chunk(RandomIter first, RandomIter last, Function &f,
+                    std::true_type) {
+  const auto len = last - first;
+  MYSTL_PRAGMA_SIMD
+  for (decltype(last - first) i = 0; i < len; ++i) {
+    f(first[i]);
+  }
+}
+
+template <class RandomIter, class Function>
+void for_each_chunk(RandomIter first, RandomIter last, Function &f,
+                    std::false_type) {
+  for (; first != last; ++first) {
+    f(*first);
+  }
+}
+
+// for_each_policy 的 input_iterator_tag 版本
+template <class InputIter, class Function, class Par, class Unseq>
+void for_each_policy(InputIter first, InputIter last, Function &f, Par, Unseq,
+                     mystl::input_iterator_tag) {
+  mystl::for_each(first, last, f);
+}
+
+// for_each_policy 的 random_access_iterator_tag 版本
+template <class RandomIter, class Function, class Unseq>
+void for_each_policy(RandomIter first, RandomIter last, Function &f,
+                     std::false_type, Unseq unseq,
+                     mystl::random_access_iterator_tag) {
+  mystl::for_each_chunk(first, last, f, unseq);
+}
+
+template <class RandomIter, class Function, class Unseq>
+void for_each_policy(RandomIter first, RandomIter last, Function &f,
+                     std::true_type, Unseq unseq,
+                     mystl::random_access_iterator_tag) {
+  const auto n = static_cast<size_t>(last - first);
+  if (n <= kParallelGrainSize) {
+    mystl::for_each_chunk(first, last, f, unseq);
+    return;
+  }
+  mystl::default_thread_pool().parallel_for(
+      first, last, mystl::parallel_grain(n),
+      [&](RandomIter l, RandomIter r) { mystl::for_each_chunk(l, r, f, unseq); });
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Function>
+enable_if_execution_policy<ExecutionPolicy, void>
+for_each(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+         Function f) {
+  mystl::for_each_policy(first, last, f, policy_parallel(policy),
+                         policy_unsequenced(policy), iterator_category(first));
+}
+
+/*****************************************************************************************/
+// max_element / min_element
+// 执行策略版本，各子区间分别求出最值后合并，相等时取位置最靠前者，
+// 结果与顺序版本一致。unseq 对这两个算法没有额外作用
+/*****************************************************************************************/
+// better 为 true 表示 lhs 应优先于 rhs 被选中
+template <class RandomIter, class Better>
+RandomIter par_select_element(RandomIter first, RandomIter last,
+                              Better better) {
+  const auto n = static_cast<size_t>(last - first);
+  if (n <= kParallelGrainSize) {
+    auto result = first;
+    for (auto i = first + 1; i < last; ++i) {
+      if (better(*i, *result)) {
+        result = i;
+      }
+    }
+    return result;
+  }
+  RandomIter result = first;
+  std::mutex mutex;
+  mystl::default_thread_pool().parallel_for(
+      first, last, mystl::parallel_grain(n), [&](RandomIter f, RandomIter l) {
+        auto local = f;
+        for (auto i = f + 1; i < l; ++i) {
+          if (better(*i, *local)) {
+            local = i;
+          }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (better(*local, *result) ||
+            (!better(*result, *local) && local < result)) {
+          result = local;
+        }
+      });
+  return result;
+}
+
+template <class ForwardIter, class Better, class Par>
+ForwardIter select_element_policy(ForwardIter first, ForwardIter last,
+                                  Better better, Par,
+                                  mystl::forward_iterator_tag) {
+  if (first == last) {
+    return last;
+  }
+  auto result = first;
+  while (++first != last) {
+    if (better(*first, *result)) {
+      result = first;
+    }
+  }
+  return result;
+}
+
+template <class RandomIter, class Better>
+RandomIter select_element_policy(RandomIter first, RandomIter last,
+                                 Better better, std::true_type,
+                                 mystl::random_access_iterator_tag) {
+  if (first == last) {
+    return last;
+  }
+  return mystl::par_select_element(first, last, better);
+}
+
+template <class ExecutionPolicy, class ForwardIter>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+max_element(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last) {
+  auto better = [](const auto &x, const auto &y) -> bool { return y < x; };
+  return mystl::select_element_policy(first, last, better,
+                                      policy_parallel(policy),
+                                      iterator_category(first));
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+max_element(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+            Compared comp) {
+  auto better = [&comp](const auto &x, const auto &y) -> bool {
+    return comp(y, x);
+  };
+  return mystl::select_element_policy(first, last, better,
+                                      policy_parallel(policy),
+                                      iterator_category(first));
+}
+
+template <class ExecutionPolicy, class ForwardIter>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+min_element(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last) {
+  auto better = [](const auto &x, const auto &y) -> bool { return x < y; };
+  return mystl::select_element_policy(first, last, better,
+                                      policy_parallel(policy),
+                                      iterator_category(first));
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+min_element(ExecutionPolicy &&policy, ForwardIter first, ForwardIter last,
+            Compared comp) {
+  auto better = [&comp](const auto &x, const auto &y) -> bool {
+    return comp(x, y);
+  };
+  return mystl::select_element_policy(first, last, better,
+                                      policy_parallel(policy),
+                                      iterator_category(first));
+}
+
+/*****************************************************************************************/
+// partition
+// 执行策略版本，par 下各子区间先各自分割，再并行交换放错一侧的元素，
+// 不需要额外的缓冲区。与顺序版本一样不保证元素的原始相对位置
+/*****************************************************************************************/
+// 若干首尾相接的区间中的一段，offset 为它之前各段的元素总数
+struct partition_span {
+  size_t first;
+  size_t last;
+  size_t offset;
+};
+
+// 找出第 t 个元素所在的段
+inline size_t
+partition_span_at(const mystl::vector<partition_span> &spans, size_t t) {
+  size_t lo = 0;
+  size_t hi = spans.size();
+  while (hi - lo > 1) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (spans[mid].offset <= t) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <class RandomIter, class UnaryPredicate>
+RandomIter par_partition(RandomIter first, RandomIter last,
+                         UnaryPredicate &unary_pred) {
+  const auto n = static_cast<size_t>(last - first);
+  if (n <= kParallelGrainSize) {
+    return mystl::partition(first, last, unary_pred);
+  }
+  auto &pool = mystl::default_thread_pool();
+  const size_t grain = mystl::parallel_grain(n);
+  const size_t chunks = (n + grain - 1) / grain;
+  mystl::vector<size_t> split;
+  split.reserve(chunks);
+  for (size_t c = 0; c < chunks; ++c) {
+    split.emplace_back(0);
+  }
+  pool.parallel_for(static_cast<size_t>(0), chunks, 1,
+                    [&](size_t cf, size_t cl) {
+                      for (size_t c = cf; c < cl; ++c) {
+                        const size_t b = c * grain;
+                        const size_t e = b + grain < n ? b + grain : n;
+                        split[c] = static_cast<size_t>(
+                            mystl::partition(first + b, first + e,
+                                             unary_pred) -
+                            first);
+                      }
+                    });
+
+  // 分割点为 mid，[0, mid) 中不满足条件的元素与 [mid, n) 中满足条件的
+  // 元素个数相同，把两者一一交换即可
+  size_t mid = 0;
+  for (size_t c = 0; c < chunks; ++c) {
+    mid += split[c] - c * grain;
+  }
+  mystl::vector<partition_span> lhs;
+  mystl::vector<partition_span> rhs;
+  size_t lcount = 0;
+  size_t rcount = 0;
+  for (size_t c = 0; c < chunks; ++c) {
+    const size_t b = c * grain;
+    const size_t e = b + grain < n ? b + grain : n;
+    const size_t le = e < mid ? e : mid;
+    if (split[c] < le) {
+      lhs.emplace_back(partition_span{split[c], le, lcount});
+      lcount += le - split[c];
+    }
+    const size_t rb = b > mid ? b : mid;
+    if (rb < split[c]) {
+      rhs.emplace_back(partition_span{rb, split[c], rcount});
+      rcount += split[c] - rb;
+    }
+  }
+  MYSTL_DEBUG(lcount == rcount);
+  pool.parallel_for(
+      static_cast<size_t>(0), lcount, mystl::parallel_grain(lcount),
+      [&](size_t tf, size_t tl) {
+        size_t a = mystl::partition_span_at(lhs, tf);
+        size_t b = mystl::partition_span_at(rhs, tf);
+        size_t i = lhs[a].first + (tf - lhs[a].offset);
+        size_t j = rhs[b].first + (tf - rhs[b].offset);
+        for (size_t t = tf; t < tl; ++t, ++i, ++j) {
+          if (i == lhs[a].last) {
+            i = lhs[++a].first;
+          }
+          if (j == rhs[b].last) {
+            j = rhs[++b].first;
+          }
+          mystl::iter_swap(first + i, first + j);
+        }
+      });
+  return first + mid;
+}
+
+template <class BidirectionalIter, class UnaryPredicate, class Par>
+BidirectionalIter partition_policy(BidirectionalIter first,
+                                   BidirectionalIter last,
+                                   UnaryPredicate &unary_pred, Par,
+                                   mystl::bidirectional_iterator_tag) {
+  return mystl::partition(first, last, unary_pred);
+}
+
+template <class RandomIter, class UnaryPredicate>
+RandomIter partition_policy(RandomIter first, RandomIter last,
+                            UnaryPredicate &unary_pred, std::true_type,
+                            mystl::random_access_iterator_tag) {
+  return mystl::par_partition(first, last, unary_pred);
+}
+
+template <class ExecutionPolicy, class BidirectionalIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, BidirectionalIter>
+partition(ExecutionPolicy &&policy, BidirectionalIter first,
+          BidirectionalIter last, UnaryPredicate unary_pred) {
+  return mystl::partition_policy(first, last, unary_pred,
+                                 policy_parallel(policy),
+                                 iterator_category(first));
+}
+
+/*****************************************************************************************/
+// nth_element
+// 执行策略版本，par 下对很长的区间先抽样选出两个把第 n 小元素夹在中间的枢轴，
+// 并行分割两次后只在中间一段继续选择，最后交给顺序版本
+/*****************************************************************************************/
+// 长度超过该值的区间才做并行分割
+constexpr static size_t kParallelSelectSize = 1 << 22;
+// 每轮抽取的样本数
+constexpr static size_t kParallelSelectSample = 1 << 14;
+// 两个枢轴在样本中与目标位置相距的样本数
+constexpr static size_t kParallelSelectBand = 256;
+
+template <class RandomIter, class Compared>
+void par_nth_element(RandomIter first, RandomIter nth, RandomIter last,
+                     Compared comp) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  while (static_cast<size_t>(last - first) > kParallelSelectSize) {
+    const auto n = static_cast<size_t>(last - first);
+    const auto k = static_cast<size_t>(nth - first);
+
+    // 每个步长内取一个伪随机位置，避免等距抽样遇到周期性的输入
+    const size_t m = kParallelSelectSample;
+    const size_t stride = n / m;
+    mystl::vector<value_type> sample;
+    sample.reserve(m);
+    uint64_t seed = n ^ (static_cast<uint64_t>(k) << 32);
+    for (size_t i = 0; i < m; ++i) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      sample.emplace_back(*(first + i * stride + (seed >> 33) % stride));
+    }
+    const size_t r = k / stride < m ? k / stride : m - 1;
+    const size_t rl = r > kParallelSelectBand ? r - kParallelSelectBand : 0;
+    const size_t rh =
+        r + kParallelSelectBand < m ? r + kParallelSelectBand : m - 1;
+    mystl::nth_element(sample.begin(), sample.begin() + rl, sample.end(),
+                       comp);
+    mystl::nth_element(sample.begin() + rl, sample.begin() + rh,
+                       sample.end(), comp);
+    const value_type lo = sample[rl];
+    const value_type hi = sample[rh];
+
+    auto below = [&](const value_type &x) { return comp(x, lo); };
+    auto cut1 = mystl::par_partition(first, last, below);
+    RandomIter new_first = first;
+    RandomIter new_last = cut1;
+    if (cut1 <= nth) {
+      auto not_above = [&](const value_type &x) { return !comp(hi, x); };
+      auto cut2 = mystl::par_partition(cut1, last, not_above);
+      if (cut2 <= nth) {
+        new_first = cut2;
+        new_last = last;
+      } else {
+        if (!comp(lo, hi)) {
+          return; // 中间一段的元素都相等
+        }
+        new_first = cut1;
+        new_last = cut2;
+      }
+    }
+    first = new_first;
+    last = new_last;
+    if (static_cast<size_t>(last - first) > n / 2) {
+      break; // 抽样失效时不再继续并行分割
+    }
+  }
+  mystl::nth_element(first, nth, last, comp);
+}
+
+template <class RandomIter, class Compared>
+void nth_element_policy(RandomIter first, RandomIter nth, RandomIter last,
+                        Compared comp, std::false_type) {
+  mystl::nth_element(first, nth, last, comp);
+}
+
+template <class RandomIter, class Compared>
+void nth_element_policy(RandomIter first, RandomIter nth, RandomIter last,
+                        Compared comp, std::true_type) {
+  if (nth == last)
+    return;
+  mystl::par_nth_element(first, nth, last, comp);
+}
+
+template <class ExecutionPolicy, class RandomIter>
+enable_if_execution_policy<ExecutionPolicy, void>
+nth_element(ExecutionPolicy &&policy, RandomIter first, RandomIter nth,
+            RandomIter last) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  mystl::nth_element_policy(first, nth, last, mystl::less<value_type>(),
+                            policy_parallel(policy));
+}
+
+template <class ExecutionPolicy, class RandomIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy, void>
+nth_element(ExecutionPolicy &&policy, RandomIter first, RandomIter nth,
+            RandomIter last, Compared comp) {
+  mystl::nth_element_policy(first, nth, last, comp, policy_parallel(policy));
+}
+
+/*****************************************************************************************/
+// shuffle
+// 执行策略版本，par 下先把区间分成若干块并行打乱，再按 MergeShuffle 的方法
+// 逐层两两合并相邻的块，每次合并只需线性次数的随机位，结果仍是均匀的随机排列。
+// 各块与各次合并使用由 g 生成种子的独立引擎，结果只取决于 g 和区间长度，
+// 与线程数无关，但与顺序版本的结果不同
+/*****************************************************************************************/
+// 每块的最小长度
+constexpr static size_t kParallelShuffleBlock = 1 << 18;
+
+// 每个随机位决定位置 i 保留左侧的下一个元素还是换入右侧的下一个元素，
+// 某一侧用完时返回 i
+template <class RandomIter, class URBG>
+RandomIter merge_shuffle_aux(RandomIter i, RandomIter j, RandomIter last,
+                             URBG &g, m_false_type) {
+  while (true) {
+    uint64_t bits = mystl::random_bits<64>(g);
+    for (int b = 0; b < 64; ++b, bits >>= 1) {
+      if (bits & 1) {
+        if (j == last)
+          return i;
+        mystl::iter_swap(i, j);
+        ++j;
+      } else if (i == j) {
+        return i;
+      }
+      ++i;
+    }
+  }
+}
+
+// 元素可以按位复制时用条件选择代替随机位上的分支，避免频繁的预测失败
+template <class RandomIter, class URBG>
+RandomIter merge_shuffle_aux(RandomIter i, RandomIter j, RandomIter last,
+                             URBG &g, m_true_type) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  while (true) {
+    uint64_t bits = mystl::random_bits<64>(g);
+    for (int b = 0; b < 64; ++b, bits >>= 1) {
+      // take_right 为 1 时检查并换入 j，为 0 时检查 i 并原地不动
+      const auto take_right = static_cast<Distance>(bits & 1);
+      const RandomIter src = i + (j - i) * take_right;
+      if (src == j + (last - j) * take_right)
+        return i;
+      const auto value = *src;
+      *src = *i;
+      *i = value;
+      j += take_right;
+      ++i;
+    }
+  }
+}
+
+// 合并两个已经均匀打乱的相邻区间 [first, mid) 与 [mid, last)
+template <class RandomIter, class URBG>
+void merge_shuffle(RandomIter first, RandomIter mid, RandomIter last,
+                   URBG &g) {
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  RandomIter i = mystl::merge_shuffle_aux(
+      first, mid, last, g,
+      m_bool_constant<std::is_trivially_copyable<value_type>::value>());
+  // 某一侧先用完时，剩余的元素逐个随机插入已合并的部分
+  for (; i != last; ++i) {
+    const auto k =
+        mystl::uniform_bounded(g, static_cast<uint64_t>(i - first) + 1);
+    mystl::iter_swap(i, first + static_cast<Distance>(k));
+  }
+}
+
+template <class RandomIter, class URBG>
+void par_shuffle(RandomIter first, RandomIter last, URBG &g) {
+  const auto n = static_cast<size_t>(last - first);
+  if (n <= 2 * kParallelShuffleBlock) {
+    mystl::shuffle(first, last, g);
+    return;
+  }
+  auto &pool = mystl::default_thread_pool();
+  const size_t blocks = std::bit_floor(n / kParallelShuffleBlock);
+  // 第 b 块从 n * b / blocks 开始，分两部分计算以免乘法溢出
+  const size_t q = n / blocks;
+  const size_t r = n % blocks;
+  auto bound = [=](size_t b) { return q * b + r * b / blocks; };
+  mystl::vector<uint64_t> seeds;
+  seeds.reserve(blocks);
+  for (size_t b = 0; b < blocks; ++b) {
+    seeds.push_back(mystl::random_bits<64>(g));
+  }
+  pool.parallel_for(static_cast<size_t>(0), blocks, 1,
+                    [&](size_t bf, size_t bl) {
+                      for (size_t b = bf; b < bl; ++b) {
+                        mystl::xoshiro256ss e(seeds[b]);
+                        mystl::shuffle(first + bound(b), first + bound(b + 1),
+                                       e);
+                      }
+                    });
+  for (size_t width = 1; width < blocks; width *= 2) {
+    const size_t pairs = blocks / (2 * width);
+    for (size_t p = 0; p < pairs; ++p) {
+      seeds[p] = mystl::random_bits<64>(g);
+    }
+    pool.parallel_for(static_cast<size_t>(0), pairs, 1,
+                      [&](size_t pf, size_t pl) {
+                        for (size_t p = pf; p < pl; ++p) {
+                          const size_t b = 2 * width * p;
+                          mystl::xoshiro256ss e(seeds[p]);
+                          mystl::merge_shuffle(first + bound(b),
+                                               first + bound(b + width),
+                                               first + bound(b + 2 * width),
+                                               e);
+                        }
+                      });
+  }
+}
+
+template <class RandomIter, class URBG>
+void shuffle_policy(RandomIter first, RandomIter last, URBG &g,
+                    std::false_type) {
+  mystl::shuffle(first, last, g);
+}
+
+template <class RandomIter, class URBG>
+void shuffle_policy(RandomIter first, RandomIter last, URBG &g,
+                    std::true_type) {
+  mystl::par_shuffle(first, last, g);
+}
+
+template <class ExecutionPolicy, class RandomIter, class URBG>
+enable_if_execution_policy<ExecutionPolicy, void>
+shuffle(ExecutionPolicy &&policy, RandomIter first, RandomIter last,
+        URBG &&g) {
+  mystl::shuffle_policy(first, last, g, policy_parallel(policy));
+}
+
+/*****************************************************************************************/
+// merge / inplace_merge
+// 执行策略版本，par 下把输出平均分段，每段的起点 d 用二分查找求出 co-rank，
+// 即合并后前 d 个元素中来自第一个序列的个数，各段随后独立地合并，
+// 结果与顺序版本相同，相等的元素中第一个序列的在前。
+// inplace_merge 能申请到整个区间长度的临时缓冲区时，先把区间移入缓冲区再
+// 并行地移动合并回原处；否则在较长一半的中点切分，二分查找另一半中的切分点，
+// 并行地旋转中间两段后对两个子问题并行递归
+/*****************************************************************************************/
+// 合并 [first1, first1 + n1) 与 [first2, first2 + n2) 后，
+// 前 d 个元素中来自第一个序列的个数
+template <class RandomIter1, class RandomIter2, class Compared>
+size_t merge_co_rank(RandomIter1 first1, size_t n1, RandomIter2 first2,
+                     size_t n2, size_t d, Compared comp) {
+  size_t lo = d > n2 ? d - n2 : 0;
+  size_t hi = d < n1 ? d : n1;
+  // 求使第二个序列取出的最后一个元素小于第一个序列的下一个元素的最小 i，
+  // i 越大这个条件越容易成立，i 取 hi 时一定成立
+  while (lo < hi) {
+    const size_t i = lo + (hi - lo) / 2;
+    if (comp(*(first2 + (d - i - 1)), *(first1 + i))) {
+      hi = i;
+    } else {
+      lo = i + 1;
+    }
+  }
+  return lo;
+}
+
+// 顺序合并一段，m_false_type 时复制元素，m_true_type 时移动元素
+template <class RandomIter1, class RandomIter2, class RandomIter3,
+          class Compared>
+RandomIter3 merge_kernel(RandomIter1 first1, RandomIter1 last1,
+                         RandomIter2 first2, RandomIter2 last2,
+                         RandomIter3 result, Compared &comp, m_false_type) {
+  return mystl::merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class RandomIter1, class RandomIter2, class RandomIter3,
+          class Compared>
+RandomIter3 merge_kernel(RandomIter1 first1, RandomIter1 last1,
+                         RandomIter2 first2, RandomIter2 last2,
+                         RandomIter3 result, Compared &comp, m_true_type) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first2, *first1)) {
+      *result = mystl::move(*first2);
+      ++first2;
+    } else {
+      *result = mystl::move(*first1);
+      ++first1;
+    }
+    ++result;
+  }
+  return mystl::move(first2, last2, mystl::move(first1, last1, result));
+}
+
+template <class RandomIter1, class RandomIter2, class RandomIter3,
+          class Compared, class MoveTag>
+RandomIter3 par_merge_aux(RandomIter1 first1, RandomIter1 last1,
+                          RandomIter2 first2, RandomIter2 last2,
+                          RandomIter3 result, Compared comp, MoveTag tag) {
+  const auto n1 = static_cast<size_t>(last1 - first1);
+  const auto n2 = static_cast<size_t>(last2 - first2);
+  const size_t n = n1 + n2;
+  if (n <= 2 * kParallelGrainSize) {
+    return mystl::merge_kernel(first1, last1, first2, last2, result, comp,
+                               tag);
+  }
+  const size_t grain = mystl::parallel_grain(n);
+  const size_t parts = (n + grain - 1) / grain;
+  // 先求出所有切分点再合并，移动合并时各段不会读到其他段已移走的元素
+  mystl::vector<size_t> split;
+  split.reserve(parts + 1);
+  for (size_t t = 0; t <= parts; ++t) {
+    split.push_back(
+        mystl::merge_co_rank(first1, n1, first2, n2, t * n / parts, comp));
+  }
+  mystl::default_thread_pool().parallel_for(
+      static_cast<size_t>(0), parts, 1, [&](size_t tf, size_t tl) {
+        for (size_t t = tf; t < tl; ++t) {
+          const size_t d0 = t * n / parts;
+          const size_t d1 = (t + 1) * n / parts;
+          const size_t i0 = split[t];
+          const size_t i1 = split[t + 1];
+          mystl::merge_kernel(first1 + i0, first1 + i1, first2 + (d0 - i0),
+                              first2 + (d1 - i1), result + d0, comp, tag);
+        }
+      });
+  return result + n;
+}
+
+template <class RandomIter1, class RandomIter2, class RandomIter3,
+          class Compared>
+RandomIter3 par_merge(RandomIter1 first1, RandomIter1 last1,
+                      RandomIter2 first2, RandomIter2 last2,
+                      RandomIter3 result, Compared comp) {
+  return mystl::par_merge_aux(first1, last1, first2, last2, result, comp,
+                              m_false_type());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter,
+          class Compared, class Par, class Tag1, class Tag2, class OutTag>
+OutputIter merge_policy(InputIter1 first1, InputIter1 last1,
+                        InputIter2 first2, InputIter2 last2,
+                        OutputIter result, Compared comp, Par, Tag1, Tag2,
+                        OutTag) {
+  return mystl::merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class RandomIter1, class RandomIter2, class RandomIter3,
+          class Compared>
+RandomIter3 merge_policy(RandomIter1 first1, RandomIter1 last1,
+                         RandomIter2 first2, RandomIter2 last2,
+                         RandomIter3 result, Compared comp, std::true_type,
+                         mystl::random_access_iterator_tag,
+                         mystl::random_access_iterator_tag,
+                         mystl::random_access_iterator_tag) {
+  return mystl::par_merge(first1, last1, first2, last2, result, comp);
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2,
+          class OutputIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+merge(ExecutionPolicy &&policy, InputIter1 first1, InputIter1 last1,
+      InputIter2 first2, InputIter2 last2, OutputIter result, Compared comp) {
+  return mystl::merge_policy(first1, last1, first2, last2, result, comp,
+                             policy_parallel(policy),
+                             iterator_category(first1),
+                             iterator_category(first2),
+                             iterator_category(result));
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2,
+          class OutputIter>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+merge(ExecutionPolicy &&policy, InputIter1 first1, InputIter1 last1,
+      InputIter2 first2, InputIter2 last2, OutputIter result) {
+  return mystl::merge(
+      policy, first1, last1, first2, last2, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+// 并行翻转，交换首尾对称的元素
+template <class RandomIter>
+void par_reverse(RandomIter first, RandomIter last) {
+  const auto half = static_cast<size_t>(last - first) / 2;
+  mystl::default_thread_pool().parallel_for(
+      static_cast<size_t>(0), half, mystl::parallel_grain(half),
+      [&](size_t l, size_t r) {
+        for (size_t i = l; i < r; ++i) {
+          mystl::iter_swap(first + i, last - 1 - i);
+        }
+      });
+}
+
+// 用三次并行翻转完成旋转，返回旋转后原 *first 所在的位置
+template <class RandomIter>
+RandomIter par_rotate(RandomIter first, RandomIter middle, RandomIter last) {
+  if (static_cast<size_t>(last - first) <= 2 * kParallelGrainSize) {
+    return mystl::rotate(first, middle, last);
+  }
+  mystl::par_reverse(first, middle);
+  mystl::par_reverse(middle, last);
+  mystl::par_reverse(first, last);
+  return first + (last - middle);
+}
+
+// 没有足够的缓冲区时，切分、旋转后并行递归，足够短的子问题顺序地无缓冲合并
+template <class RandomIter, class Compared>
+void par_inplace_merge_rotate(RandomIter first, RandomIter middle,
+                              RandomIter last, Compared comp) {
+  const auto len1 = middle - first;
+  const auto len2 = last - middle;
+  if (len1 == 0 || len2 == 0) {
+    return;
+  }
+  if (static_cast<size_t>(len1 + len2) <= 2 * kParallelGrainSize) {
+    mystl::merge_without_buffer(first, middle, last, len1, len2, comp);
+    return;
+  }
+  RandomIter first_cut = first;
+  RandomIter second_cut = middle;
+  if (len1 > len2) {
+    first_cut = first + len1 / 2;
+    second_cut = mystl::lower_bound(middle, last, *first_cut, comp);
+  } else {
+    second_cut = middle + len2 / 2;
+    first_cut = mystl::upper_bound(first, middle, *second_cut, comp);
+  }
+  RandomIter new_middle = mystl::par_rotate(first_cut, middle, second_cut);
+  mystl::default_thread_pool().parallel_invoke(
+      [&]() {
+        mystl::par_inplace_merge_rotate(first, first_cut, new_middle, comp);
+      },
+      [&]() {
+        mystl::par_inplace_merge_rotate(new_middle, second_cut, last, comp);
+      });
+}
+
+template <class RandomIter, class Compared>
+void par_inplace_merge(RandomIter first, RandomIter middle, RandomIter last,
+                       Compared comp) {
+  typedef typename iterator_traits<RandomIter>::value_type T;
+  const auto n = last - first;
+  auto buffer = mystl::get_temporary_buffer<T>(n);
+  if (buffer.second < n) {
+    mystl::release_temporary_buffer(buffer.first);
+    mystl::par_inplace_merge_rotate(first, middle, last, comp);
+    return;
+  }
+  // 缓冲区中的元素由移动构造得到，离开时析构并释放
+  struct buffer_guard {
+    T *p;
+    ptrdiff_t n;
+    ~buffer_guard() {
+      mystl::destroy(p, p + n);
+      mystl::release_temporary_buffer(p);
+    }
+  } guard{buffer.first, 0};
+  T *const buf = buffer.first;
+  mystl::uninitialized_move(first, last, buf);
+  guard.n = n;
+  mystl::par_merge_aux(buf, buf + (middle - first), buf + (middle - first),
+                       buf + n, first, comp, m_true_type());
+}
+
+template <class BidirectionalIter, class Compared, class Par, class Tag>
+void inplace_merge_policy(BidirectionalIter first, BidirectionalIter middle,
+                          BidirectionalIter last, Compared comp, Par, Tag) {
+  mystl::inplace_merge(first, middle, last, comp);
+}
+
+template <class RandomIter, class Compared>
+void inplace_merge_policy(RandomIter first, RandomIter middle,
+                          RandomIter last, Compared comp, std::true_type,
+                          mystl::random_access_iterator_tag) {
+  if (first == middle || middle == last)
+    return;
+  mystl::par_inplace_merge(first, middle, last, comp);
+}
+
+template <class ExecutionPolicy, class BidirectionalIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy, void>
+inplace_merge(ExecutionPolicy &&policy, BidirectionalIter first,
+              BidirectionalIter middle, BidirectionalIter last,
+              Compared comp) {
+  mystl::inplace_merge_policy(first, middle, last, comp,
+                              policy_parallel(policy),
+                              iterator_category(first));
+}
+
+template <class ExecutionPolicy, class BidirectionalIter>
+enable_if_execution_policy<ExecutionPolicy, void>
+inplace_merge(ExecutionPolicy &&policy, BidirectionalIter first,
+              BidirectionalIter middle, BidirectionalIter last) {
+  mystl::inplace_merge(
+      policy, first, middle, last,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+/*****************************************************************************************/
+// multiway_merge
+// 执行策略版本，par 下用 multiseq_select 求出把输出平均分段时各序列的分割点，
+// 各段独立地归并到输出中互不重叠的位置，结果与顺序版本相同。
+// 只有各序列与 result 都可随机访问时才会并行
+/*****************************************************************************************/
+template <class RangeIter, class RandomIter, class Compared>
+RandomIter par_multiway_merge(RangeIter rfirst, RangeIter rlast,
+                              RandomIter result, Compared comp) {
+  typedef typename iterator_traits<RangeIter>::value_type range_type;
+  mystl::vector<range_type> seqs;
+  size_t n = 0;
+  for (; rfirst != rlast; ++rfirst) {
+    seqs.push_back(*rfirst);
+    n += static_cast<size_t>((*rfirst).second - (*rfirst).first);
+  }
+  const size_t k = seqs.size();
+  if (n <= 2 * kParallelGrainSize || k < 2) {
+    return mystl::multiway_merge(seqs.begin(), seqs.end(), result, comp);
+  }
+  auto &pool = mystl::default_thread_pool();
+  const size_t grain = mystl::parallel_grain(n);
+  const size_t parts = (n + grain - 1) / grain;
+  // 第 t 段从合并后的第 t * n / parts 个元素开始，在第 j 个序列中
+  // 从 split[t * k + j] 开始
+  mystl::vector<size_t> split;
+  split.reserve((parts + 1) * k);
+  for (size_t i = 0; i < (parts + 1) * k; ++i) {
+    split.push_back(i < parts * k
+                        ? 0
+                        : static_cast<size_t>(seqs[i - parts * k].second -
+                                              seqs[i - parts * k].first));
+  }
+  pool.parallel_for(static_cast<size_t>(1), parts, 1,
+                    [&](size_t tf, size_t tl) {
+                      for (size_t t = tf; t < tl; ++t) {
+                        mystl::multiseq_select(seqs.begin(), seqs.end(),
+                                               t * n / parts,
+                                               split.data() + t * k, comp);
+                      }
+                    });
+  pool.parallel_for(
+      static_cast<size_t>(0), parts, 1, [&](size_t tf, size_t tl) {
+        mystl::vector<range_type> sub;
+        sub.reserve(k);
+        for (size_t t = tf; t < tl; ++t) {
+          sub.clear();
+          for (size_t j = 0; j < k; ++j) {
+            sub.push_back(range_type(seqs[j].first + split[t * k + j],
+                                     seqs[j].first + split[(t + 1) * k + j]));
+          }
+          mystl::multiway_merge(sub.begin(), sub.end(), result + t * n / parts,
+                                comp);
+        }
+      });
+  return result + n;
+}
+
+template <class RangeIter, class OutputIter, class Compared, class Par,
+          class SeqTag, class OutTag>
+OutputIter multiway_merge_policy(RangeIter rfirst, RangeIter rlast,
+                                 OutputIter result, Compared comp, Par, SeqTag,
+                                 OutTag) {
+  return mystl::multiway_merge(rfirst, rlast, result, comp);
+}
+
+template <class RangeIter, class RandomIter, class Compared>
+RandomIter multiway_merge_policy(RangeIter rfirst, RangeIter rlast,
+                                 RandomIter result, Compared comp,
+                                 std::true_type,
+                                 mystl::random_access_iterator_tag,
+                                 mystl::random_access_iterator_tag) {
+  return mystl::par_multiway_merge(rfirst, rlast, result, comp);
+}
+
+template <class ExecutionPolicy, class RangeIter, class OutputIter,
+          class Compared>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+multiway_merge(ExecutionPolicy &&policy, RangeIter rfirst, RangeIter rlast,
+               OutputIter result, Compared comp) {
+  typedef typename iterator_traits<RangeIter>::value_type::first_type Iter;
+  typedef typename iterator_traits<Iter>::iterator_category seq_category;
+  return mystl::multiway_merge_policy(rfirst, rlast, result, comp,
+                                      policy_parallel(policy), seq_category(),
+                                      iterator_category(result));
+}
+
+template <class ExecutionPolicy, class RangeIter, class OutputIter>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+multiway_merge(ExecutionPolicy &&policy, RangeIter rfirst, RangeIter rlast,
+               OutputIter result) {
+  return mystl::multiway_merge(
+      policy, rfirst, rlast, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_PARALLEL_ALGO_H_
@@ -0,0 +1,164 @@
+#ifndef MYTINYSTL_QUEUE_H_
+#define MYTINYSTL_QUEUE_H_
+
+// 这个头文件包含一个模板类 priority_queue
+// priority_queue : 优先队列
+
+// notes:
+//
+// 底层容器默认为 mystl::vector，用 d 叉堆组织元素，Arity 为每个节点的
+// 子节点数，默认为 4。比较函数为 less 时堆顶为最大的元素。
+// push_pop 与 replace_top 只做一次下滤，比先 pop 再 push 少一半的调整
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "exceptdef.h"
+#include "functional.h"
+#include "heap_algo.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+// 模板类 priority_queue
+// 参数一代表数据类型，参数二代表容器类型，参数三代表比较权值的方式，
+// 参数四代表堆的叉数
+template <class T, class Container = mystl::vector<T>,
+          class Compare = mystl::less<typename Container::value_type>,
+          size_t Arity = 4>
+class priority_queue {
+public:
+  typedef Container container_type;
+  typedef Compare value_compare;
+  // 使用底层容器的型别
+  typedef typename Container::value_type value_type;
+  typedef typename Container::size_type size_type;
+  typedef typename Container::difference_type difference_type;
+  typedef typename Container::reference reference;
+  typedef typename Container::const_reference const_reference;
+
+  static_assert(std::is_same<T, value_type>::value,
+                "the value_type of Container should be same with T");
+
+private:
+  container_type c_;   // 用底层容器来表现 priority_queue
+  value_compare comp_; // 权值比较的标准
+
+public:
+  // 构造、复制、移动函数
+  priority_queue() = default;
+
+  explicit priority_queue(const Compare &c) : c_(), comp_(c) {}
+
+  template <class IIter>
+  priority_queue(IIter first, IIter last) : c_(first, last), comp_() {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  template <class IIter>
+  priority_queue(IIter first, IIter last, const Compare &c)
+      : c_(first, last), comp_(c) {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(std::initializer_list<T> ilist)
+      : c_(ilist.begin(), ilist.end()), comp_() {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(const Compare &c, const Container &s) : c_(s), comp_(c) {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(const Compare &c, Container &&s)
+      : c_(mystl::move(s)), comp_(c) {
+    mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  priority_queue(const priority_queue &rhs) = default;
+  priority_queue(priority_queue &&rhs) = default;
+  priority_queue &operator=(const priority_queue &rhs) = default;
+  priority_queue &operator=(priority_queue &&rhs) = default;
+
+  ~priority_queue() = default;
+
+public:
+  // 访问元素相关操作
+  const_reference top() const {
+    MYSTL_DEBUG(!empty());
+    return c_.front();
+  }
+
+  // 容量相关操作
+  bool empty() const noexcept { return c_.empty(); }
+  size_type size() const noexcept { return c_.size(); }
+
+  // 修改容器相关操作
+  template <class... Args> void emplace(Args &&...args) {
+    c_.emplace_back(mystl::forward<Args>(args)...);
+    mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  void push(const value_type &value) {
+    c_.push_back(value);
+    mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  void push(value_type &&value) {
+    c_.push_back(mystl::move(value));
+    mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+  }
+
+  void pop() {
+    MYSTL_DEBUG(!empty());
+    mystl::dary_pop_heap<Arity>(c_.begin(), c_.end(), comp_);
+    c_.pop_back();
+  }
+
+  // 相当于先 push(value) 再 pop()，返回被弹出的元素
+  // value 不比堆顶小时直接返回 value，堆保持不变
+  value_type push_pop(value_type value) {
+    if (c_.empty() || !comp_(value, c_.front())) {
+      return value;
+    }
+    return replace_root(mystl::move(value));
+  }
+
+  // 相当于先 pop() 再 push(value)，返回原来的堆顶
+  value_type replace_top(value_type value) {
+    MYSTL_DEBUG(!empty());
+    return replace_root(mystl::move(value));
+  }
+
+  void clear() { c_.clear(); }
+
+  void swap(priority_queue &rhs) noexcept(
+      noexcept(mystl::swap(c_, rhs.c_)) &&
+      noexcept(mystl::swap(comp_, rhs.comp_))) {
+    mystl::swap(c_, rhs.c_);
+    mystl::swap(comp_, rhs.comp_);
+  }
+
+private:
+  // 取出堆顶，把 value 放到堆顶后下滤
+  value_type replace_root(value_type &&value) {
+    value_type top = mystl::move(c_.front());
+    mystl::dary_sift_down<Arity>(c_.begin(), static_cast<difference_type>(0),
+                                 static_cast<difference_type>(c_.size()),
+                                 mystl::move(value), comp_);
+    return top;
+  }
+};
+
+// 重载 mystl 的 swap
+template <class T, class Container, class Compare, size_t Arity>
+void swap(priority_queue<T, Container, Compare, Arity> &lhs,
+          priority_queue<T, Container, Compare, Arity> &rhs)
+    noexcept(noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_QUEUE_H_
@@ -0,0 +1,321 @@
+#ifndef MYTINYSTL_RANDOM_H_
+#define MYTINYSTL_RANDOM_H_
+
+// 这个头文件包含几个伪随机数引擎：splitmix64, xoshiro256ss, pcg32，
+// 每个线程独立的默认引擎 thread_random_engine，
+// 以及生成 [0, bound) 内均匀整数的 uniform_bounded 和 (0, 1) 内均匀浮点数的
+// uniform_real01
+
+// notes:
+//
+// 三个引擎都满足 UniformRandomBitGenerator 的要求，可以传给 std 的分布。
+// splitmix64 状态只有 64 位，主要用于把一个种子展开成其他引擎的状态；
+// xoshiro256ss 速度快、周期 2^256 - 1，jump() 跳过 2^128 步，
+// 可以从同一个种子得到互不重叠的多个子序列；
+// pcg32 状态小，输出 32 位，可以用 stream 参数选择不同的序列。
+//
+// uniform_bounded 使用 Lemire 的乘法缩放方法：把随机数乘以 bound 取高位，
+// 只有低位落在很小的拒绝区间内时才需要一次取模并重新抽取，
+// 绝大多数情况下不做除法，且结果没有取模带来的偏差
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace mystl {
+
+/*****************************************************************************************/
+// splitmix64
+/*****************************************************************************************/
+class splitmix64 {
+public:
+  typedef uint64_t result_type;
+
+  explicit splitmix64(uint64_t seed = 0) noexcept : state_(seed) {}
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+  void seed(uint64_t seed) noexcept { state_ = seed; }
+
+  result_type operator()() noexcept {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  friend bool operator==(const splitmix64 &lhs,
+                         const splitmix64 &rhs) noexcept {
+    return lhs.state_ == rhs.state_;
+  }
+
+private:
+  uint64_t state_;
+};
+
+/*****************************************************************************************/
+// xoshiro256ss
+// xoshiro256**，状态由 splitmix64 从种子展开，保证不全为零
+/*****************************************************************************************/
+class xoshiro256ss {
+public:
+  typedef uint64_t result_type;
+
+  explicit xoshiro256ss(uint64_t seed = 0) noexcept { this->seed(seed); }
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+  void seed(uint64_t seed) noexcept {
+    splitmix64 sm(seed);
+    for (auto &s : s_) {
+      s = sm();
+    }
+  }
+
+  result_type operator()() noexcept {
+    const uint64_t result = std::rotl(s_[1] * 5, 7) * 9;
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = std::rotl(s_[3], 45);
+    return result;
+  }
+
+  // 相当于调用 2^128 次 operator()
+  void jump() noexcept {
+    constexpr uint64_t kJump[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                  0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (uint64_t j : kJump) {
+      for (int b = 0; b < 64; ++b) {
+        if (j & (static_cast<uint64_t>(1) << b)) {
+          for (int k = 0; k < 4; ++k) {
+            s[k] ^= s_[k];
+          }
+        }
+        (*this)();
+      }
+    }
+    for (int k = 0; k < 4; ++k) {
+      s_[k] = s[k];
+    }
+  }
+
+  friend bool operator==(const xoshiro256ss &lhs,
+                         const xoshiro256ss &rhs) noexcept {
+    for (int k = 0; k < 4; ++k) {
+      if (lhs.s_[k] != rhs.s_[k])
+        return false;
+    }
+    return true;
+  }
+
+private:
+  uint64_t s_[4];
+};
+
+/*****************************************************************************************/
+// pcg32
+// PCG XSH RR 64/32，stream 决定增量，不同的 stream 给出不同的序列
+/*****************************************************************************************/
+class pcg32 {
+public:
+  typedef uint32_t result_type;
+
+  explicit pcg32(uint64_t seed = 0x853c49e6748fea9bULL,
+                 uint64_t stream = 0xda3e39cb94b95bdbULL) noexcept {
+    this->seed(seed, stream);
+  }
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return UINT32_MAX; }
+
+  void seed(uint64_t seed, uint64_t stream = 0xda3e39cb94b95bdbULL) noexcept {
+    state_ = 0;
+    inc_ = (stream << 1) | 1;
+    step();
+    state_ += seed;
+    step();
+  }
+
+  result_type operator()() noexcept {
+    const uint64_t old = state_;
+    step();
+    const auto xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+    const auto rot = static_cast<int>(old >> 59);
+    return std::rotr(xorshifted, rot);
+  }
+
+  friend bool operator==(const pcg32 &lhs, const pcg32 &rhs) noexcept {
+    return lhs.state_ == rhs.state_ && lhs.inc_ == rhs.inc_;
+  }
+
+private:
+  void step() noexcept { state_ = state_ * 6364136223846793005ULL + inc_; }
+
+  uint64_t state_;
+  uint64_t inc_;
+};
+
+typedef xoshiro256ss default_random_engine;
+
+/*****************************************************************************************/
+// thread_random_engine
+// 返回当前线程独有的默认引擎，首次使用时用时钟、线程私有地址和全局计数器
+// 生成种子，不同线程、同一线程先后两次运行得到的序列都不同
+/*****************************************************************************************/
+inline uint64_t random_seed() noexcept {
+  static std::atomic<uint64_t> counter{0};
+  const auto now = static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+  thread_local char anchor;
+  splitmix64 sm(now ^ reinterpret_cast<uintptr_t>(&anchor));
+  return sm() ^ counter.fetch_add(0x9e3779b97f4a7c15ULL,
+                                  std::memory_order_relaxed);
+}
+
+inline default_random_engine &thread_random_engine() noexcept {
+  thread_local default_random_engine engine(mystl::random_seed());
+  return engine;
+}
+
+/*****************************************************************************************/
+// uniform_bounded
+// 返回 [0, bound) 内均匀分布的整数，bound 必须大于 0
+/*****************************************************************************************/
+// 求 a * b 的高 64 位，低 64 位写入 lo
+inline uint64_t mul_hi_lo(uint64_t a, uint64_t b, uint64_t &lo) noexcept {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+  lo = static_cast<uint64_t>(p);
+  return static_cast<uint64_t>(p >> 64);
+#else
+  const uint64_t a_lo = a & 0xffffffffULL;
+  const uint64_t a_hi = a >> 32;
+  const uint64_t b_lo = b & 0xffffffffULL;
+  const uint64_t b_hi = b >> 32;
+  const uint64_t ll = a_lo * b_lo;
+  const uint64_t lh = a_lo * b_hi;
+  const uint64_t hl = a_hi * b_lo;
+  const uint64_t mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+  lo = (mid << 32) | (ll & 0xffffffffULL);
+  return a_hi * b_hi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// 引擎每次调用能提供的完整随机位数
+template <class URBG>
+constexpr int urbg_bits() noexcept {
+  typedef typename std::remove_reference<URBG>::type engine;
+  typedef typename engine::result_type result_type;
+  constexpr auto range = static_cast<uint64_t>(engine::max() - engine::min());
+  static_assert(std::is_unsigned<result_type>::value,
+                "URBG must produce unsigned integers");
+  return range == UINT64_MAX ? 64 : std::bit_width(range + 1) - 1;
+}
+
+// 从引擎中取出一次调用所能提供的全部随机位
+template <class URBG> uint64_t random_draw(URBG &g) {
+  typedef typename std::remove_reference<URBG>::type engine;
+  constexpr int kBits = mystl::urbg_bits<URBG>();
+  static_assert(kBits > 0, "URBG range is too small");
+  if constexpr (kBits == 64) {
+    return static_cast<uint64_t>(g() - engine::min());
+  } else {
+    constexpr auto range = static_cast<uint64_t>(engine::max() - engine::min());
+    while (true) {
+      const auto v = static_cast<uint64_t>(g() - engine::min());
+      // 值域不是 2 的幂时丢弃超出 kBits 位的结果
+      if (range + 1 == (static_cast<uint64_t>(1) << kBits) || (v >> kBits) == 0)
+        return v;
+    }
+  }
+}
+
+// 从引擎中取出 Bits 个均匀的随机位
+template <int Bits, class URBG> uint64_t random_bits(URBG &g) {
+  constexpr int kBits = mystl::urbg_bits<URBG>();
+  uint64_t r = mystl::random_draw(g);
+  if constexpr (kBits < Bits) {
+    for (int got = kBits; got < Bits; got += kBits) {
+      r = (r << kBits) ^ mystl::random_draw(g);
+    }
+  }
+  if constexpr (Bits < 64) {
+    r &= (static_cast<uint64_t>(1) << Bits) - 1;
+  }
+  return r;
+}
+
+template <class URBG> uint32_t uniform_bounded32(URBG &g, uint32_t bound) {
+  uint64_t m = mystl::random_bits<32>(g) * bound;
+  auto l = static_cast<uint32_t>(m);
+  if (l < bound) {
+    const uint32_t t = (0u - bound) % bound;
+    while (l < t) {
+      m = mystl::random_bits<32>(g) * bound;
+      l = static_cast<uint32_t>(m);
+    }
+  }
+  return static_cast<uint32_t>(m >> 32);
+}
+
+template <class URBG> uint64_t uniform_bounded64(URBG &g, uint64_t bound) {
+  uint64_t l;
+  uint64_t h = mystl::mul_hi_lo(mystl::random_bits<64>(g), bound, l);
+  if (l < bound) {
+    const uint64_t t = (0 - bound) % bound;
+    while (l < t) {
+      h = mystl::mul_hi_lo(mystl::random_bits<64>(g), bound, l);
+    }
+  }
+  return h;
+}
+
+// 返回 (0, 1) 内均匀分布的浮点数，取值为 2^-53 的奇数倍，
+// 范围为 [2^-53, 1 - 2^-53]。只取 52 位，k + 0.5 不超过 2^52，
+// 在 double 中可以精确表示；取 53 位时 k + 0.5 会被舍入，可能得到 1
+template <class URBG> double uniform_real01(URBG &g) {
+  return (static_cast<double>(mystl::random_bits<52>(g)) + 0.5) * 0x1.0p-52;
+}
+
+// 引擎本身输出 64 位时总是使用 64 位乘法，否则尽量只消耗 32 位
+template <class URBG> uint64_t uniform_bounded(URBG &g, uint64_t bound) {
+  if constexpr (mystl::urbg_bits<URBG>() < 64) {
+    if (bound <= UINT32_MAX) {
+      return mystl::uniform_bounded32(g, static_cast<uint32_t>(bound));
+    }
+  }
+  return mystl::uniform_bounded64(g, bound);
+}
+
+// 用一个 64 位随机数同时生成 [0, bound1) 和 [0, bound2) 内的两个整数，
+// 要求 bound1 * bound2 小于 2^64，引擎输出 64 位
+template <class URBG>
+void uniform_bounded_pair(URBG &g, uint64_t bound1, uint64_t bound2,
+                          uint64_t &r1, uint64_t &r2) {
+  static_assert(mystl::urbg_bits<URBG>() == 64, "URBG must produce 64 bits");
+  uint64_t l;
+  r1 = mystl::mul_hi_lo(mystl::random_bits<64>(g), bound1, l);
+  r2 = mystl::mul_hi_lo(l, bound2, l);
+  const uint64_t product = bound1 * bound2;
+  if (l < product) {
+    const uint64_t t = (0 - product) % product;
+    while (l < t) {
+      r1 = mystl::mul_hi_lo(mystl::random_bits<64>(g), bound1, l);
+      r2 = mystl::mul_hi_lo(l, bound2, l);
+    }
+  }
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_RANDOM_H_
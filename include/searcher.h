@@ -0,0 +1,419 @@
+#ifndef MYTINYSTL_SEARCHER_H_
+#define MYTINYSTL_SEARCHER_H_
+
+// 这个头文件包含一组子串查找器(searcher)，通过 search(first, last, searcher)
+// 在 [first, last) 中查找构造时给定的模式
+// default_searcher              : 逐个位置比较
+// boyer_moore_horspool_searcher : Boyer-Moore-Horspool 算法，平均次线性
+// boyer_moore_searcher          : Boyer-Moore 算法，使用坏字符与好后缀规则
+// two_way_searcher              : Two-Way 算法，最坏线性时间，常数额外空间
+// byte_filter_searcher          : 单字节区间上的向量化首尾字节筛选
+//
+// 查找器的 operator() 返回匹配区间 [match_first, match_last)，
+// 找不到时返回 [last, last)。查找器保存模式的迭代器，不复制模式本身
+
+#include <cstddef>
+#include <type_traits>
+
+#include "algo.h"
+#include "functional.h"
+#include "iterator.h"
+#include "simd.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+/*****************************************************************************************/
+// search_skip_table
+// Boyer-Moore 类算法的坏字符表，记录模式中每个元素对应的移动距离
+// 单字节整数且使用默认相等比较时使用 256 项数组，否则使用开放寻址的散列表
+/*****************************************************************************************/
+template <class RandomIter, class Value, class Hash, class BinaryPredicate,
+          bool Small>
+class search_skip_table;
+
+template <class RandomIter, class Value, class Hash, class BinaryPredicate>
+class search_skip_table<RandomIter, Value, Hash, BinaryPredicate, true> {
+public:
+  search_skip_table(RandomIter pattern, size_t, Value default_value, Hash,
+                    BinaryPredicate)
+      : pattern_(pattern) {
+    for (size_t i = 0; i < 256; ++i) {
+      table_[i] = default_value;
+    }
+  }
+
+  // 为模式中第 i 个元素设置移动距离
+  void insert(size_t i, Value value) {
+    table_[static_cast<unsigned char>(pattern_[i])] = value;
+  }
+
+  template <class Key> Value find(const Key &key) const {
+    return table_[static_cast<unsigned char>(key)];
+  }
+
+private:
+  RandomIter pattern_;
+  Value table_[256];
+};
+
+template <class RandomIter, class Value, class Hash, class BinaryPredicate>
+class search_skip_table<RandomIter, Value, Hash, BinaryPredicate, false> {
+public:
+  search_skip_table(RandomIter pattern, size_t n, Value default_value,
+                    Hash hf, BinaryPredicate pred)
+      : pattern_(pattern), default_(default_value), hash_(hf), pred_(pred) {
+    size_t cap = 8;
+    while (cap < n * 2) {
+      cap <<= 1;
+    }
+    mask_ = cap - 1;
+    slots_.reserve(cap);
+    values_.reserve(cap);
+    for (size_t i = 0; i < cap; ++i) {
+      slots_.emplace_back(kEmpty);
+      values_.emplace_back(default_value);
+    }
+  }
+
+  // 为模式中第 i 个元素设置移动距离，相等的元素共用一个槽位
+  void insert(size_t i, Value value) {
+    size_t pos = static_cast<size_t>(hash_(pattern_[i])) & mask_;
+    while (slots_[pos] != kEmpty &&
+           !pred_(pattern_[slots_[pos]], pattern_[i])) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = i;
+    values_[pos] = value;
+  }
+
+  template <class Key> Value find(const Key &key) const {
+    size_t pos = static_cast<size_t>(hash_(key)) & mask_;
+    while (slots_[pos] != kEmpty) {
+      if (pred_(key, pattern_[slots_[pos]])) {
+        return values_[pos];
+      }
+      pos = (pos + 1) & mask_;
+    }
+    return default_;
+  }
+
+private:
+  static constexpr size_t kEmpty = static_cast<size_t>(-1);
+
+  RandomIter pattern_;
+  Value default_;
+  Hash hash_;
+  BinaryPredicate pred_;
+  size_t mask_;
+  mystl::vector<size_t> slots_;
+  mystl::vector<Value> values_;
+};
+
+// 是否可以使用 256 项数组作为坏字符表
+template <class T, class BinaryPredicate>
+struct is_small_skip_table
+    : public m_bool_constant<
+          std::is_integral<T>::value && sizeof(T) == 1 &&
+          std::is_same<BinaryPredicate, mystl::equal_to<T>>::value> {};
+
+/*****************************************************************************************/
+// default_searcher
+// 使用 mystl::search 逐个位置比较
+/*****************************************************************************************/
+template <class ForwardIter,
+          class BinaryPredicate = mystl::equal_to<
+              typename iterator_traits<ForwardIter>::value_type>>
+class default_searcher {
+public:
+  default_searcher(ForwardIter pat_first, ForwardIter pat_last,
+                   BinaryPredicate pred = BinaryPredicate())
+      : pat_first_(pat_first), pat_last_(pat_last), pred_(pred) {}
+
+  template <class ForwardIter2>
+  mystl::pair<ForwardIter2, ForwardIter2> operator()(ForwardIter2 first,
+                                                     ForwardIter2 last) const {
+    auto it = mystl::search(first, last, pat_first_, pat_last_, pred_);
+    auto match_last = it;
+    if (it != last) {
+      mystl::advance(match_last, mystl::distance(pat_first_, pat_last_));
+    }
+    return mystl::pair<ForwardIter2, ForwardIter2>(it, match_last);
+  }
+
+private:
+  ForwardIter pat_first_;
+  ForwardIter pat_last_;
+  BinaryPredicate pred_;
+};
+
+/*****************************************************************************************/
+// boyer_moore_horspool_searcher
+// 每次从模式末尾开始比较，失配时按窗口最后一个元素在模式中的位置移动窗口
+// 要求 hf 与 pred 一致：pred(a, b) 为 true 时 hf(a) == hf(b)
+/*****************************************************************************************/
+template <class RandomIter,
+          class Hash =
+              mystl::hash<typename iterator_traits<RandomIter>::value_type>,
+          class BinaryPredicate =
+              mystl::equal_to<typename iterator_traits<RandomIter>::value_type>>
+class boyer_moore_horspool_searcher {
+public:
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  typedef typename iterator_traits<RandomIter>::difference_type
+      difference_type;
+
+private:
+  typedef search_skip_table<
+      RandomIter, difference_type, Hash, BinaryPredicate,
+      is_small_skip_table<value_type, BinaryPredicate>::value>
+      table_type;
+
+public:
+  boyer_moore_horspool_searcher(RandomIter pat_first, RandomIter pat_last,
+                                Hash hf = Hash(),
+                                BinaryPredicate pred = BinaryPredicate())
+      : pat_first_(pat_first), pat_last_(pat_last), pred_(pred),
+        skip_(pat_first, static_cast<size_t>(pat_last - pat_first),
+              pat_last - pat_first, hf, pred) {
+    const difference_type m = pat_last - pat_first;
+    for (difference_type i = 0; i + 1 < m; ++i) {
+      skip_.insert(static_cast<size_t>(i), m - 1 - i);
+    }
+  }
+
+  template <class RandomIter2>
+  mystl::pair<RandomIter2, RandomIter2> operator()(RandomIter2 first,
+                                                   RandomIter2 last) const {
+    const difference_type m = pat_last_ - pat_first_;
+    if (m == 0) {
+      return mystl::pair<RandomIter2, RandomIter2>(first, first);
+    }
+    while (last - first >= m) {
+      difference_type j = m - 1;
+      while (pred_(first[j], pat_first_[j])) {
+        if (j == 0) {
+          return mystl::pair<RandomIter2, RandomIter2>(first, first + m);
+        }
+        --j;
+      }
+      first += skip_.find(first[m - 1]);
+    }
+    return mystl::pair<RandomIter2, RandomIter2>(last, last);
+  }
+
+private:
+  RandomIter pat_first_;
+  RandomIter pat_last_;
+  BinaryPredicate pred_;
+  table_type skip_;
+};
+
+/*****************************************************************************************/
+// boyer_moore_searcher
+// 在 Boyer-Moore-Horspool 的基础上增加好后缀规则，取两者中较大的移动距离
+/*****************************************************************************************/
+template <class RandomIter,
+          class Hash =
+              mystl::hash<typename iterator_traits<RandomIter>::value_type>,
+          class BinaryPredicate =
+              mystl::equal_to<typename iterator_traits<RandomIter>::value_type>>
+class boyer_moore_searcher {
+public:
+  typedef typename iterator_traits<RandomIter>::value_type value_type;
+  typedef typename iterator_traits<RandomIter>::difference_type
+      difference_type;
+
+private:
+  typedef search_skip_table<
+      RandomIter, difference_type, Hash, BinaryPredicate,
+      is_small_skip_table<value_type, BinaryPredicate>::value>
+      table_type;
+
+public:
+  boyer_moore_searcher(RandomIter pat_first, RandomIter pat_last,
+                       Hash hf = Hash(),
+                       BinaryPredicate pred = BinaryPredicate())
+      : pat_first_(pat_first), pat_last_(pat_last), pred_(pred),
+        skip_(pat_first, static_cast<size_t>(pat_last - pat_first),
+              pat_last - pat_first, hf, pred) {
+    const difference_type m = pat_last - pat_first;
+    for (difference_type i = 0; i + 1 < m; ++i) {
+      skip_.insert(static_cast<size_t>(i), m - 1 - i);
+    }
+    build_good_suffix(m);
+  }
+
+  template <class RandomIter2>
+  mystl::pair<RandomIter2, RandomIter2> operator()(RandomIter2 first,
+                                                   RandomIter2 last) const {
+    const difference_type m = pat_last_ - pat_first_;
+    if (m == 0) {
+      return mystl::pair<RandomIter2, RandomIter2>(first, first);
+    }
+    while (last - first >= m) {
+      difference_type i = m - 1;
+      while (i >= 0 && pred_(first[i], pat_first_[i])) {
+        --i;
+      }
+      if (i < 0) {
+        return mystl::pair<RandomIter2, RandomIter2>(first, first + m);
+      }
+      const difference_type bad = skip_.find(first[i]) - m + 1 + i;
+      first += mystl::max(good_suffix_[static_cast<size_t>(i)], bad);
+    }
+    return mystl::pair<RandomIter2, RandomIter2>(last, last);
+  }
+
+private:
+  void build_good_suffix(difference_type m);
+
+private:
+  RandomIter pat_first_;
+  RandomIter pat_last_;
+  BinaryPredicate pred_;
+  table_type skip_;
+  mystl::vector<difference_type> good_suffix_;
+};
+
+// 计算好后缀规则的移动距离
+// suff[i] 为以 i 结尾的、同时是模式后缀的最长子串长度
+template <class RandomIter, class Hash, class BinaryPredicate>
+void boyer_moore_searcher<RandomIter, Hash, BinaryPredicate>::build_good_suffix(
+    difference_type m) {
+  if (m == 0) {
+    return;
+  }
+  const auto x = pat_first_;
+  mystl::vector<difference_type> suff;
+  suff.reserve(static_cast<size_t>(m));
+  good_suffix_.reserve(static_cast<size_t>(m));
+  for (difference_type i = 0; i < m; ++i) {
+    suff.emplace_back(m);
+    good_suffix_.emplace_back(m);
+  }
+  difference_type f = m - 1, g = m - 1;
+  for (difference_type i = m - 2; i >= 0; --i) {
+    if (i > g && suff[i + m - 1 - f] < i - g) {
+      suff[i] = suff[i + m - 1 - f];
+    } else {
+      if (i < g) {
+        g = i;
+      }
+      f = i;
+      while (g >= 0 && pred_(x[g], x[g + m - 1 - f])) {
+        --g;
+      }
+      suff[i] = f - g;
+    }
+  }
+  difference_type j = 0;
+  for (difference_type i = m - 1; i >= 0; --i) {
+    if (suff[i] == i + 1) {
+      for (; j < m - 1 - i; ++j) {
+        if (good_suffix_[j] == m) {
+          good_suffix_[j] = m - 1 - i;
+        }
+      }
+    }
+  }
+  for (difference_type i = 0; i + 1 < m; ++i) {
+    good_suffix_[m - 1 - suff[i]] = m - 1 - i;
+  }
+}
+
+/*****************************************************************************************/
+// two_way_searcher
+// 构造时求出模式的临界分解，查找时最坏 O(n + m) 次比较
+// comp 为元素间的严格弱序
+/*****************************************************************************************/
+template <class RandomIter,
+          class Compared =
+              mystl::less<typename iterator_traits<RandomIter>::value_type>>
+class two_way_searcher {
+public:
+  typedef typename iterator_traits<RandomIter>::difference_type
+      difference_type;
+
+  two_way_searcher(RandomIter pat_first, RandomIter pat_last,
+                   Compared comp = Compared())
+      : pat_first_(pat_first), m_(pat_last - pat_first), ell_(0), per_(1),
+        periodic_(false), comp_(comp) {
+    if (m_ != 0) {
+      periodic_ = mystl::two_way_factorize(pat_first_, m_, ell_, per_, comp_);
+    }
+  }
+
+  template <class RandomIter2>
+  mystl::pair<RandomIter2, RandomIter2> operator()(RandomIter2 first,
+                                                   RandomIter2 last) const {
+    if (m_ == 0) {
+      return mystl::pair<RandomIter2, RandomIter2>(first, first);
+    }
+    if (last - first < m_) {
+      return mystl::pair<RandomIter2, RandomIter2>(last, last);
+    }
+    auto it = mystl::two_way_search_aux(first, last, pat_first_, m_, ell_,
+                                        per_, periodic_, comp_);
+    return mystl::pair<RandomIter2, RandomIter2>(it, it == last ? last
+                                                                : it + m_);
+  }
+
+private:
+  RandomIter pat_first_;
+  difference_type m_;
+  difference_type ell_;
+  difference_type per_;
+  bool periodic_;
+  Compared comp_;
+};
+
+/*****************************************************************************************/
+// byte_filter_searcher
+// 只用于单字节整数的连续区间，先用向量比较筛选首尾字节都匹配的位置，再用
+// memcmp 验证。对较短的模式很快，但最坏情况为 O(n * m)
+/*****************************************************************************************/
+template <class CharT> class byte_filter_searcher {
+  static_assert(std::is_integral<CharT>::value && sizeof(CharT) == 1,
+                "byte_filter_searcher requires a one-byte integral type");
+
+public:
+  byte_filter_searcher(const CharT *pat_first, const CharT *pat_last)
+      : pat_first_(pat_first), m_(static_cast<size_t>(pat_last - pat_first)) {}
+
+  template <class Tp>
+  typename std::enable_if<
+      std::is_same<typename std::remove_const<Tp>::type, CharT>::value,
+      mystl::pair<Tp *, Tp *>>::type
+  operator()(Tp *first, Tp *last) const {
+    if (m_ == 0) {
+      return mystl::pair<Tp *, Tp *>(first, first);
+    }
+    const CharT *it =
+        m_ == 1 ? mystl::simd_find<CharT>(first, last, *pat_first_)
+                : mystl::simd_search<CharT>(first, last, pat_first_, m_);
+    if (it == last) {
+      return mystl::pair<Tp *, Tp *>(last, last);
+    }
+    Tp *match = first + (it - first);
+    return mystl::pair<Tp *, Tp *>(match, match + m_);
+  }
+
+private:
+  const CharT *pat_first_;
+  size_t m_;
+};
+
+/*****************************************************************************************/
+// search
+// 使用查找器 searcher 在 [first, last) 中查找，返回第一个匹配的起点
+/*****************************************************************************************/
+template <class ForwardIter, class Searcher>
+ForwardIter search(ForwardIter first, ForwardIter last,
+                   const Searcher &searcher) {
+  return searcher(first, last).first;
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_SEARCHER_H_
@@ -0,0 +1,409 @@
+#ifndef MYTINYSTL_SET_ALGO_H_
+#define MYTINYSTL_SET_ALGO_H_
+
+// 这个头文件包含 set 的四种算法: union, intersection, difference,
+// symmetric_difference，以及多个序列的交集 multiway_set_intersection
+// 所有函数都要求序列有序
+
+// notes:
+//
+// 两个序列都可以随机访问且长度相差悬殊时，intersection 与 difference
+// 遍历较短的序列，在较长的序列中用倍增查找(galloping)跳过整段不可能匹配的
+// 元素，比较次数从 O(m + n) 降为 O(m log(n / m))。
+// 严格递增的 uint32_t 序列(如倒排表)可以使用 set_intersection_u32，
+// 长度接近时使用向量化的块比较
+
+#include <cstddef>
+#include <cstdint>
+
+#include "algo.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "simd.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+// 长度相差这么多倍以上时使用倍增查找
+constexpr static size_t kSetGallopRatio = 16;
+// set_intersection_u32 的向量化比较更快，相差更多时才使用倍增查找
+constexpr static size_t kSimdGallopRatio = 64;
+
+/*****************************************************************************************/
+// gallop_lower_bound
+// 从 first 开始以 1, 2, 4, ... 的步长向后查找，再在最后一步内二分，
+// 返回第一个不小于 value 的位置，所需比较次数只与该位置到 first 的距离有关
+/*****************************************************************************************/
+template <class RandomIter, class T, class Compared>
+RandomIter gallop_lower_bound(RandomIter first, RandomIter last,
+                              const T &value, Compared comp) {
+  typedef typename iterator_traits<RandomIter>::difference_type Distance;
+  const Distance len = last - first;
+  if (len == 0 || !comp(*first, value)) {
+    return first;
+  }
+  // 不变式：first[lo] < value
+  Distance lo = 0;
+  Distance step = 1;
+  while (lo + step < len && comp(*(first + (lo + step)), value)) {
+    lo += step;
+    step *= 2;
+  }
+  const Distance hi = lo + step < len ? lo + step : len;
+  return mystl::lower_bound(first + (lo + 1), first + hi, value, comp);
+}
+
+/*****************************************************************************************/
+// set_union
+// 计算 S1∪S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_union(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                     InputIter2 last2, OutputIter result, Compared comp) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first1, *first2)) {
+      *result = *first1;
+      ++first1;
+    } else if (comp(*first2, *first1)) {
+      *result = *first2;
+      ++first2;
+    } else {
+      *result = *first1;
+      ++first1;
+      ++first2;
+    }
+    ++result;
+  }
+  // 将剩余元素拷贝到 result
+  return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_union(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                     InputIter2 last2, OutputIter result) {
+  return mystl::set_union(
+      first1, last1, first2, last2, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+/*****************************************************************************************/
+// set_intersection
+// 计算 S1∩S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+// 相等的元素取自 S1
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection_merge(InputIter1 first1, InputIter1 last1,
+                                  InputIter2 first2, InputIter2 last2,
+                                  OutputIter result, Compared &comp) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first1, *first2)) {
+      ++first1;
+    } else if (comp(*first2, *first1)) {
+      ++first2;
+    } else {
+      *result = *first1;
+      ++first1;
+      ++first2;
+      ++result;
+    }
+  }
+  return result;
+}
+
+// 遍历较短的序列，在较长的序列中倍增查找
+template <class RandomIter1, class RandomIter2, class OutputIter,
+          class Compared>
+OutputIter set_intersection_gallop(RandomIter1 first1, RandomIter1 last1,
+                                   RandomIter2 first2, RandomIter2 last2,
+                                   OutputIter result, Compared &comp) {
+  if (last1 - first1 <= last2 - first2) {
+    for (; first1 != last1; ++first1) {
+      first2 = mystl::gallop_lower_bound(first2, last2, *first1, comp);
+      if (first2 == last2)
+        break;
+      if (!comp(*first1, *first2)) {
+        *result = *first1;
+        ++result;
+        ++first2;
+      }
+    }
+  } else {
+    for (; first2 != last2; ++first2) {
+      first1 = mystl::gallop_lower_bound(first1, last1, *first2, comp);
+      if (first1 == last1)
+        break;
+      if (!comp(*first2, *first1)) {
+        *result = *first1;
+        ++result;
+        ++first1;
+      }
+    }
+  }
+  return result;
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection_dispatch(InputIter1 first1, InputIter1 last1,
+                                     InputIter2 first2, InputIter2 last2,
+                                     OutputIter result, Compared &comp,
+                                     mystl::input_iterator_tag,
+                                     mystl::input_iterator_tag) {
+  return mystl::set_intersection_merge(first1, last1, first2, last2, result,
+                                       comp);
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter,
+          class Compared>
+OutputIter set_intersection_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                     RandomIter2 first2, RandomIter2 last2,
+                                     OutputIter result, Compared &comp,
+                                     mystl::random_access_iterator_tag,
+                                     mystl::random_access_iterator_tag) {
+  const auto n1 = static_cast<size_t>(last1 - first1);
+  const auto n2 = static_cast<size_t>(last2 - first2);
+  if (n1 / kSetGallopRatio >= n2 || n2 / kSetGallopRatio >= n1) {
+    return mystl::set_intersection_gallop(first1, last1, first2, last2,
+                                          result, comp);
+  }
+  return mystl::set_intersection_merge(first1, last1, first2, last2, result,
+                                       comp);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result, Compared comp) {
+  return mystl::set_intersection_dispatch(first1, last1, first2, last2, result,
+                                          comp, iterator_category(first1),
+                                          iterator_category(first2));
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                            InputIter2 first2, InputIter2 last2,
+                            OutputIter result) {
+  return mystl::set_intersection(
+      first1, last1, first2, last2, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+/*****************************************************************************************/
+// set_intersection_u32
+// 求两个严格递增的 uint32_t 序列的交集，result 至少能容纳较短序列的长度，
+// 返回一个指针指向输出结果的尾部
+/*****************************************************************************************/
+inline uint32_t *set_intersection_u32(const uint32_t *first1,
+                                      const uint32_t *last1,
+                                      const uint32_t *first2,
+                                      const uint32_t *last2,
+                                      uint32_t *result) {
+  const auto n1 = static_cast<size_t>(last1 - first1);
+  const auto n2 = static_cast<size_t>(last2 - first2);
+  if (n1 / kSimdGallopRatio >= n2 || n2 / kSimdGallopRatio >= n1) {
+    auto comp = mystl::less<uint32_t>();
+    return mystl::set_intersection_gallop(first1, last1, first2, last2,
+                                          result, comp);
+  }
+  return result + mystl::simd_intersect_u32(first1, n1, first2, n2, result);
+}
+
+/*****************************************************************************************/
+// set_difference
+// 计算 S1-S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference_merge(InputIter1 first1, InputIter1 last1,
+                                InputIter2 first2, InputIter2 last2,
+                                OutputIter result, Compared &comp) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first1, *first2)) {
+      *result = *first1;
+      ++first1;
+      ++result;
+    } else if (comp(*first2, *first1)) {
+      ++first2;
+    } else {
+      ++first1;
+      ++first2;
+    }
+  }
+  return mystl::copy(first1, last1, result);
+}
+
+// S2 远短于 S1 时，S1 中两个 S2 元素之间的部分整段拷贝；
+// S1 远短于 S2 时，对 S1 的每个元素在 S2 中倍增查找
+template <class RandomIter1, class RandomIter2, class OutputIter,
+          class Compared>
+OutputIter set_difference_gallop(RandomIter1 first1, RandomIter1 last1,
+                                 RandomIter2 first2, RandomIter2 last2,
+                                 OutputIter result, Compared &comp) {
+  if (last1 - first1 <= last2 - first2) {
+    for (; first1 != last1; ++first1) {
+      first2 = mystl::gallop_lower_bound(first2, last2, *first1, comp);
+      if (first2 == last2)
+        break;
+      if (comp(*first1, *first2)) {
+        *result = *first1;
+        ++result;
+      } else {
+        ++first2;
+      }
+    }
+  } else {
+    for (; first2 != last2 && first1 != last1; ++first2) {
+      RandomIter1 next = mystl::gallop_lower_bound(first1, last1, *first2,
+                                                   comp);
+      result = mystl::copy(first1, next, result);
+      first1 = next;
+      if (first1 != last1 && !comp(*first2, *first1)) {
+        ++first1;
+      }
+    }
+  }
+  return mystl::copy(first1, last1, result);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference_dispatch(InputIter1 first1, InputIter1 last1,
+                                   InputIter2 first2, InputIter2 last2,
+                                   OutputIter result, Compared &comp,
+                                   mystl::input_iterator_tag,
+                                   mystl::input_iterator_tag) {
+  return mystl::set_difference_merge(first1, last1, first2, last2, result,
+                                     comp);
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter,
+          class Compared>
+OutputIter set_difference_dispatch(RandomIter1 first1, RandomIter1 last1,
+                                   RandomIter2 first2, RandomIter2 last2,
+                                   OutputIter result, Compared &comp,
+                                   mystl::random_access_iterator_tag,
+                                   mystl::random_access_iterator_tag) {
+  const auto n1 = static_cast<size_t>(last1 - first1);
+  const auto n2 = static_cast<size_t>(last2 - first2);
+  if (n1 / kSetGallopRatio >= n2 || n2 / kSetGallopRatio >= n1) {
+    return mystl::set_difference_gallop(first1, last1, first2, last2, result,
+                                        comp);
+  }
+  return mystl::set_difference_merge(first1, last1, first2, last2, result,
+                                     comp);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result, Compared comp) {
+  return mystl::set_difference_dispatch(first1, last1, first2, last2, result,
+                                        comp, iterator_category(first1),
+                                        iterator_category(first2));
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_difference(InputIter1 first1, InputIter1 last1,
+                          InputIter2 first2, InputIter2 last2,
+                          OutputIter result) {
+  return mystl::set_difference(
+      first1, last1, first2, last2, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+/*****************************************************************************************/
+// set_symmetric_difference
+// 计算 (S1-S2)∪(S2-S1) 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result, Compared comp) {
+  while (first1 != last1 && first2 != last2) {
+    if (comp(*first1, *first2)) {
+      *result = *first1;
+      ++first1;
+      ++result;
+    } else if (comp(*first2, *first1)) {
+      *result = *first2;
+      ++first2;
+      ++result;
+    } else {
+      ++first1;
+      ++first2;
+    }
+  }
+  return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter set_symmetric_difference(InputIter1 first1, InputIter1 last1,
+                                    InputIter2 first2, InputIter2 last2,
+                                    OutputIter result) {
+  return mystl::set_symmetric_difference(
+      first1, last1, first2, last2, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+/*****************************************************************************************/
+// multiway_set_intersection
+// 求多个有序序列的交集并保存到 result 中，返回一个迭代器指向输出结果的尾部
+// [rfirst, rlast) 中的每个元素是一个 mystl::pair，first 与 second 为一个
+// 可随机访问的序列的首尾。从最短的序列中取候选值，依次在其余序列中倍增查找，
+// 某个序列中找到更大的值时，用它在最短的序列中跳过所有更小的候选值。
+// 相等的元素取自最短的序列，重复的元素保留各序列中出现次数的最小值
+/*****************************************************************************************/
+template <class RangeIter, class OutputIter, class Compared>
+OutputIter multiway_set_intersection(RangeIter rfirst, RangeIter rlast,
+                                     OutputIter result, Compared comp) {
+  typedef typename iterator_traits<RangeIter>::value_type range_type;
+  mystl::vector<range_type> ranges;
+  for (; rfirst != rlast; ++rfirst) {
+    ranges.push_back(*rfirst);
+  }
+  const size_t k = ranges.size();
+  if (k == 0) {
+    return result;
+  }
+  // 按长度从短到长排列，序列数通常很少，直接插入排序
+  for (size_t i = 1; i < k; ++i) {
+    for (size_t j = i; j > 0 && ranges[j].second - ranges[j].first <
+                                    ranges[j - 1].second - ranges[j - 1].first;
+         --j) {
+      mystl::swap(ranges[j], ranges[j - 1]);
+    }
+  }
+  auto &lead = ranges[0];
+  while (lead.first != lead.second) {
+    size_t i = 1;
+    for (; i < k; ++i) {
+      auto &r = ranges[i];
+      r.first = mystl::gallop_lower_bound(r.first, r.second, *lead.first, comp);
+      if (r.first == r.second)
+        return result;
+      if (comp(*lead.first, *r.first))
+        break;
+    }
+    if (i == k) {
+      *result = *lead.first;
+      ++result;
+      ++lead.first;
+      for (size_t j = 1; j < k; ++j) {
+        ++ranges[j].first;
+      }
+    } else {
+      lead.first = mystl::gallop_lower_bound(lead.first, lead.second,
+                                             *ranges[i].first, comp);
+    }
+  }
+  return result;
+}
+
+template <class RangeIter, class OutputIter>
+OutputIter multiway_set_intersection(RangeIter rfirst, RangeIter rlast,
+                                     OutputIter result) {
+  return mystl::multiway_set_intersection(
+      rfirst, rlast, result,
+      [](const auto &x, const auto &y) -> bool { return x < y; });
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_SET_ALGO_H_
@@ -0,0 +1,774 @@
+#ifndef MYTINYSTL_SIMD_H_
+#define MYTINYSTL_SIMD_H_
+
+// 这个头文件包含 find, count, mismatch, equal, search, fill 以及有序 uint32_t
+// 序列求交集在连续内存上使用的向量化内核，以及预取提示 simd_prefetch
+// x86 平台上使用 SSE2，运行时检测到 AVX2 时使用 AVX2，其余平台使用标量循环
+// 定义 MYSTL_NO_SIMD 可以关闭向量化
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "type_traits.h"
+
+#if !defined(MYSTL_NO_SIMD) &&                                                 \
+    (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+     defined(_M_IX86)) &&                                                      \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MYSTL_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// 填充的字节数不小于该值时使用不经过缓存的流式写入，
+// 此时写入的数据超出末级缓存，经过缓存只会挤出其他数据
+#ifndef MYSTL_SIMD_STREAM_THRESHOLD
+#define MYSTL_SIMD_STREAM_THRESHOLD (static_cast<size_t>(16) << 20)
+#endif
+
+// 只对 AVX2 版本的函数开启 AVX2 指令，其余代码不受影响
+#if defined(MYSTL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MYSTL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MYSTL_TARGET_AVX2
+#endif
+
+namespace mystl {
+
+// is_simd_value
+// 可以按位比较或用向量浮点比较的元素类型：除 bool 外的整数，float 和 double
+template <class T>
+struct is_simd_value
+    : public m_bool_constant<
+          (std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+           (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+            sizeof(T) == 8)) ||
+          std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+// 元素类型为 T 的区间中查找 Up 类型的值时可否使用向量化版本
+// 整数之间比较时值会先被转换为 T，见 simd_find_value_fits
+template <class T, class Up>
+struct is_simd_find_value
+    : public m_bool_constant<
+          is_simd_value<T>::value &&
+          ((std::is_integral<T>::value && std::is_integral<Up>::value &&
+            !std::is_same<Up, bool>::value) ||
+           std::is_same<T, Up>::value)> {};
+
+// *it == value 先做整数提升和寻常算术转换，在公共类型 C 中比较。
+// T 到 C 的转换是单射，所以 value 转换为 T 后在 C 中仍与 value 相等时，
+// 按 T 逐位比较与 == 的结果相同；否则区间中不可能有相等元素。
+// 例如 short 与 unsigned short 的 65535 比较时，C 为 int，-1 != 65535
+template <class T, class Up>
+constexpr bool simd_find_value_fits(const Up &value) {
+  typedef typename std::common_type<decltype(+T()), decltype(+Up())>::type C;
+  return static_cast<C>(static_cast<T>(value)) == static_cast<C>(value);
+}
+
+static_assert(!simd_find_value_fits<short>(static_cast<unsigned short>(65535)),
+              "short never equals unsigned short 65535");
+static_assert(!simd_find_value_fits<signed char>(
+                  static_cast<unsigned char>(255)),
+              "signed char never equals unsigned char 255");
+static_assert(simd_find_value_fits<unsigned>(-1),
+              "unsigned equals -1 after the usual arithmetic conversions");
+
+// is_simd_fill_value
+// 可以把值的二进制表示重复铺满向量来填充的元素类型：
+// 大小为 2、4、8 或 16 字节的可平凡拷贝类型，单字节类型直接使用 memset
+template <class T>
+struct is_simd_fill_value
+    : public m_bool_constant<std::is_trivially_copyable<T>::value &&
+                             !std::is_same<T, bool>::value &&
+                             (sizeof(T) == 2 || sizeof(T) == 4 ||
+                              sizeof(T) == 8 || sizeof(T) == 16)> {};
+
+// simd_prefetch
+// 提示处理器把 p 所在的缓存行提前读入缓存，对非指针的迭代器不做任何事
+// 参数取 T * 而不是 const T *，否则非 const 指针会精确匹配下面的通用版本
+template <class T> inline void simd_prefetch(T *p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(static_cast<const void *>(p));
+#elif defined(MYSTL_SIMD_X86)
+  _mm_prefetch(reinterpret_cast<const char *>(p), _MM_HINT_T0);
+#else
+  (void)p;
+#endif
+}
+
+template <class Iter> inline void simd_prefetch(const Iter &) noexcept {}
+
+#ifdef MYSTL_SIMD_X86
+
+inline unsigned simd_ctz(unsigned x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward(&index, x);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+inline unsigned simd_popcount(unsigned x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  x = x - ((x >> 1) & 0x55555555u);
+  x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+  return (((x + (x >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+#else
+  return static_cast<unsigned>(__builtin_popcount(x));
+#endif
+}
+
+inline bool simd_detect_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  __cpuid(info, 1);
+  // 需要操作系统保存 ymm 寄存器
+  if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// 是否可以使用 AVX2，只检测一次
+inline bool simd_avx2_enabled() {
+  static const bool enabled = simd_detect_avx2();
+  return enabled;
+}
+
+// simd_ops
+// 按元素大小与是否为浮点数给出广播与相等比较操作
+// 比较结果为字节掩码，每个元素占 Size 位
+template <size_t Size, bool Float> struct simd_ops;
+
+template <> struct simd_ops<1, false> {
+  typedef int8_t bits_type;
+  static __m128i set1(bits_type v) { return _mm_set1_epi8(v); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+  }
+  MYSTL_TARGET_AVX2 static __m256i set1_256(bits_type v) {
+    return _mm256_set1_epi8(v);
+  }
+  MYSTL_TARGET_AVX2 static unsigned eq_256(__m256i a, __m256i b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+  }
+};
+
+template <> struct simd_ops<2, false> {
+  typedef int16_t bits_type;
+  static __m128i set1(bits_type v) { return _mm_set1_epi16(v); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)));
+  }
+  MYSTL_TARGET_AVX2 static __m256i set1_256(bits_type v) {
+    return _mm256_set1_epi16(v);
+  }
+  MYSTL_TARGET_AVX2 static unsigned eq_256(__m256i a, __m256i b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+  }
+};
+
+template <> struct simd_ops<4, false> {
+  typedef int32_t bits_type;
+  static __m128i set1(bits_type v) { return _mm_set1_epi32(v); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)));
+  }
+  MYSTL_TARGET_AVX2 static __m256i set1_256(bits_type v) {
+    return _mm256_set1_epi32(v);
+  }
+  MYSTL_TARGET_AVX2 static unsigned eq_256(__m256i a, __m256i b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)));
+  }
+};
+
+template <> struct simd_ops<8, false> {
+  typedef int64_t bits_type;
+  static __m128i set1(bits_type v) {
+    return _mm_set_epi32(static_cast<int>(v >> 32), static_cast<int>(v),
+                         static_cast<int>(v >> 32), static_cast<int>(v));
+  }
+  // SSE2 没有 64 位整数比较，两个 32 位部分都相等时才相等
+  static unsigned eq(__m128i a, __m128i b) {
+    const __m128i c = _mm_cmpeq_epi32(a, b);
+    const __m128i d = _mm_and_si128(c, _mm_shuffle_epi32(c, 0xb1));
+    return static_cast<unsigned>(_mm_movemask_epi8(d));
+  }
+  MYSTL_TARGET_AVX2 static __m256i set1_256(bits_type v) {
+    return _mm256_set1_epi64x(v);
+  }
+  MYSTL_TARGET_AVX2 static unsigned eq_256(__m256i a, __m256i b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b)));
+  }
+};
+
+template <> struct simd_ops<4, true> {
+  typedef int32_t bits_type;
+  static __m128i set1(bits_type v) { return _mm_set1_epi32(v); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(
+        _mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)))));
+  }
+  MYSTL_TARGET_AVX2 static __m256i set1_256(bits_type v) {
+    return _mm256_set1_epi32(v);
+  }
+  MYSTL_TARGET_AVX2 static unsigned eq_256(__m256i a, __m256i b) {
+    return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(
+        _mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b),
+                      _CMP_EQ_OQ))));
+  }
+};
+
+template <> struct simd_ops<8, true> {
+  typedef int64_t bits_type;
+  static __m128i set1(bits_type v) { return simd_ops<8, false>::set1(v); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(
+        _mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)))));
+  }
+  MYSTL_TARGET_AVX2 static __m256i set1_256(bits_type v) {
+    return _mm256_set1_epi64x(v);
+  }
+  MYSTL_TARGET_AVX2 static unsigned eq_256(__m256i a, __m256i b) {
+    return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(
+        _mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b),
+                      _CMP_EQ_OQ))));
+  }
+};
+
+template <class T>
+struct simd_ops_of
+    : public simd_ops<sizeof(T), std::is_floating_point<T>::value> {};
+
+// 取出 value 的二进制表示
+template <class T>
+typename simd_ops_of<T>::bits_type simd_bits(const T &value) {
+  typename simd_ops_of<T>::bits_type bits;
+  std::memcpy(&bits, &value, sizeof(T));
+  return bits;
+}
+
+/*****************************************************************************************/
+// simd_find
+// 在 [first, last) 中找到第一个等于 value 的元素
+/*****************************************************************************************/
+template <class T>
+MYSTL_TARGET_AVX2 const T *simd_find_avx2(const T *first, const T *last,
+                                          T value) {
+  typedef simd_ops_of<T> ops;
+  constexpr size_t step = 32 / sizeof(T);
+  const __m256i v = ops::set1_256(mystl::simd_bits(value));
+  for (; static_cast<size_t>(last - first) >= step; first += step) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+    const unsigned mask = ops::eq_256(x, v);
+    if (mask != 0) {
+      return first + mystl::simd_ctz(mask) / sizeof(T);
+    }
+  }
+  for (; first != last; ++first) {
+    if (*first == value) {
+      break;
+    }
+  }
+  return first;
+}
+
+template <class T>
+const T *simd_find_sse2(const T *first, const T *last, T value) {
+  typedef simd_ops_of<T> ops;
+  constexpr size_t step = 16 / sizeof(T);
+  const __m128i v = ops::set1(mystl::simd_bits(value));
+  for (; static_cast<size_t>(last - first) >= step; first += step) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    const unsigned mask = ops::eq(x, v);
+    if (mask != 0) {
+      return first + mystl::simd_ctz(mask) / sizeof(T);
+    }
+  }
+  for (; first != last; ++first) {
+    if (*first == value) {
+      break;
+    }
+  }
+  return first;
+}
+
+template <class T>
+const T *simd_find(const T *first, const T *last, T value) {
+  if (sizeof(T) == 1 && std::is_integral<T>::value) {
+    if (first == last) {
+      return last;
+    }
+    const void *p = std::memchr(first, static_cast<unsigned char>(value),
+                                static_cast<size_t>(last - first));
+    return p == nullptr ? last : static_cast<const T *>(p);
+  }
+  if (mystl::simd_avx2_enabled()) {
+    return mystl::simd_find_avx2(first, last, value);
+  }
+  return mystl::simd_find_sse2(first, last, value);
+}
+
+/*****************************************************************************************/
+// simd_count
+// 统计 [first, last) 中等于 value 的元素个数
+/*****************************************************************************************/
+template <class T>
+MYSTL_TARGET_AVX2 size_t simd_count_avx2(const T *first, const T *last,
+                                         T value) {
+  typedef simd_ops_of<T> ops;
+  constexpr size_t step = 32 / sizeof(T);
+  const __m256i v = ops::set1_256(mystl::simd_bits(value));
+  size_t bytes = 0;
+  for (; static_cast<size_t>(last - first) >= step; first += step) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+    bytes += mystl::simd_popcount(ops::eq_256(x, v));
+  }
+  size_t n = bytes / sizeof(T);
+  for (; first != last; ++first) {
+    if (*first == value) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+template <class T>
+size_t simd_count_sse2(const T *first, const T *last, T value) {
+  typedef simd_ops_of<T> ops;
+  constexpr size_t step = 16 / sizeof(T);
+  const __m128i v = ops::set1(mystl::simd_bits(value));
+  size_t bytes = 0;
+  for (; static_cast<size_t>(last - first) >= step; first += step) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    bytes += mystl::simd_popcount(ops::eq(x, v));
+  }
+  size_t n = bytes / sizeof(T);
+  for (; first != last; ++first) {
+    if (*first == value) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+template <class T> size_t simd_count(const T *first, const T *last, T value) {
+  if (mystl::simd_avx2_enabled()) {
+    return mystl::simd_count_avx2(first, last, value);
+  }
+  return mystl::simd_count_sse2(first, last, value);
+}
+
+/*****************************************************************************************/
+// simd_mismatch
+// 返回两个长度为 n 的区间中第一处不相等元素的下标，全部相等时返回 n
+/*****************************************************************************************/
+template <class T>
+MYSTL_TARGET_AVX2 size_t simd_mismatch_avx2(const T *first1, const T *first2,
+                                            size_t n) {
+  typedef simd_ops_of<T> ops;
+  constexpr size_t step = 32 / sizeof(T);
+  size_t i = 0;
+  for (; n - i >= step; i += step) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first1 + i));
+    const __m256i y =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first2 + i));
+    const unsigned mask = ~ops::eq_256(x, y);
+    if (mask != 0) {
+      return i + mystl::simd_ctz(mask) / sizeof(T);
+    }
+  }
+  while (i != n && first1[i] == first2[i]) {
+    ++i;
+  }
+  return i;
+}
+
+template <class T>
+size_t simd_mismatch_sse2(const T *first1, const T *first2, size_t n) {
+  typedef simd_ops_of<T> ops;
+  constexpr size_t step = 16 / sizeof(T);
+  size_t i = 0;
+  for (; n - i >= step; i += step) {
+    const __m128i x =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(first1 + i));
+    const __m128i y =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(first2 + i));
+    const unsigned mask = ops::eq(x, y) ^ 0xffffu;
+    if (mask != 0) {
+      return i + mystl::simd_ctz(mask) / sizeof(T);
+    }
+  }
+  while (i != n && first1[i] == first2[i]) {
+    ++i;
+  }
+  return i;
+}
+
+template <class T>
+size_t simd_mismatch(const T *first1, const T *first2, size_t n) {
+  if (mystl::simd_avx2_enabled()) {
+    return mystl::simd_mismatch_avx2(first1, first2, n);
+  }
+  return mystl::simd_mismatch_sse2(first1, first2, n);
+}
+
+/*****************************************************************************************/
+// simd_search
+// 在 [first, last) 中查找长度为 m(m >= 2) 的单字节模式 pattern
+// 先用向量比较同时筛选首字节与末字节都匹配的位置，再用 memcmp 验证中间部分
+/*****************************************************************************************/
+template <class T>
+const T *simd_search_tail(const T *first, const T *last, const T *pattern,
+                          size_t m) {
+  const T *end = last - (m - 1);
+  for (; first < end; ++first) {
+    if (first[0] == pattern[0] && first[m - 1] == pattern[m - 1] &&
+        std::memcmp(first + 1, pattern + 1, m - 2) == 0) {
+      return first;
+    }
+  }
+  return last;
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 const T *simd_search_avx2(const T *first, const T *last,
+                                            const T *pattern, size_t m) {
+  typedef simd_ops_of<T> ops;
+  const __m256i vf = ops::set1_256(mystl::simd_bits(pattern[0]));
+  const __m256i vl = ops::set1_256(mystl::simd_bits(pattern[m - 1]));
+  const T *end = last - (m - 1);
+  for (; end - first >= 32; first += 32) {
+    const __m256i a =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + m - 1));
+    unsigned mask = ops::eq_256(a, vf) & ops::eq_256(b, vl);
+    while (mask != 0) {
+      const unsigned i = mystl::simd_ctz(mask);
+      if (std::memcmp(first + i + 1, pattern + 1, m - 2) == 0) {
+        return first + i;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return mystl::simd_search_tail(first, last, pattern, m);
+}
+
+template <class T>
+const T *simd_search_sse2(const T *first, const T *last, const T *pattern,
+                          size_t m) {
+  typedef simd_ops_of<T> ops;
+  const __m128i vf = ops::set1(mystl::simd_bits(pattern[0]));
+  const __m128i vl = ops::set1(mystl::simd_bits(pattern[m - 1]));
+  const T *end = last - (m - 1);
+  for (; end - first >= 16; first += 16) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(first + m - 1));
+    unsigned mask = ops::eq(a, vf) & ops::eq(b, vl);
+    while (mask != 0) {
+      const unsigned i = mystl::simd_ctz(mask);
+      if (std::memcmp(first + i + 1, pattern + 1, m - 2) == 0) {
+        return first + i;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return mystl::simd_search_tail(first, last, pattern, m);
+}
+
+template <class T>
+const T *simd_search(const T *first, const T *last, const T *pattern,
+                     size_t m) {
+  if (static_cast<size_t>(last - first) < m) {
+    return last;
+  }
+  if (mystl::simd_avx2_enabled()) {
+    return mystl::simd_search_avx2(first, last, pattern, m);
+  }
+  return mystl::simd_search_sse2(first, last, pattern, m);
+}
+
+/*****************************************************************************************/
+// simd_intersect_u32
+// 求两个严格递增的 uint32_t 序列的交集，结果写入 out，返回结果的个数
+// 每次取两边各一块，把一块与另一块的所有循环移位逐一比较得到匹配掩码，
+// 不经分支地写出匹配的元素，再前移块内最大值较小的一边。
+// 写入位置不会超过 min(na, nb)，out 的长度不小于它即可
+/*****************************************************************************************/
+inline size_t simd_intersect_tail(const uint32_t *a, size_t na, size_t i,
+                                  const uint32_t *b, size_t nb, size_t j,
+                                  uint32_t *out, size_t k) {
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      out[k++] = a[i];
+      ++i;
+      ++j;
+    }
+  }
+  return k;
+}
+
+MYSTL_TARGET_AVX2 inline size_t simd_intersect_u32_avx2(const uint32_t *a,
+                                                        size_t na,
+                                                        const uint32_t *b,
+                                                        size_t nb,
+                                                        uint32_t *out) {
+  const __m256i rot = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  while (i + 8 <= na && j + 8 <= nb) {
+    const __m256i va =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+    __m256i m = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; ++r) {
+      vb = _mm256_permutevar8x32_epi32(vb, rot);
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+    }
+    const auto mask = static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(m)));
+    for (int t = 0; t < 8; ++t) {
+      out[k] = a[i + t];
+      k += (mask >> t) & 1;
+    }
+    const uint32_t amax = a[i + 7];
+    const uint32_t bmax = b[j + 7];
+    i += amax <= bmax ? 8 : 0;
+    j += bmax <= amax ? 8 : 0;
+  }
+  return mystl::simd_intersect_tail(a, na, i, b, nb, j, out, k);
+}
+
+inline size_t simd_intersect_u32_sse2(const uint32_t *a, size_t na,
+                                      const uint32_t *b, size_t nb,
+                                      uint32_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  while (i + 4 <= na && j + 4 <= nb) {
+    const __m128i va =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    const __m128i vb =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+    __m128i m = _mm_cmpeq_epi32(va, vb);
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4e)));
+    m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93)));
+    const auto mask =
+        static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m)));
+    for (int t = 0; t < 4; ++t) {
+      out[k] = a[i + t];
+      k += (mask >> t) & 1;
+    }
+    const uint32_t amax = a[i + 3];
+    const uint32_t bmax = b[j + 3];
+    i += amax <= bmax ? 4 : 0;
+    j += bmax <= amax ? 4 : 0;
+  }
+  return mystl::simd_intersect_tail(a, na, i, b, nb, j, out, k);
+}
+
+inline size_t simd_intersect_u32(const uint32_t *a, size_t na,
+                                 const uint32_t *b, size_t nb, uint32_t *out) {
+  if (mystl::simd_avx2_enabled()) {
+    return mystl::simd_intersect_u32_avx2(a, na, b, nb, out);
+  }
+  return mystl::simd_intersect_u32_sse2(a, na, b, nb, out);
+}
+
+/*****************************************************************************************/
+// simd_fill
+// 把 [first, first + n) 的每个元素置为 value，T 满足 is_simd_fill_value。
+// 把 value 的字节重复铺满一个向量，首尾各做一次非对齐写入，中间按对齐地址写入，
+// 对齐地址相对 first 的偏移不是 sizeof(T) 的倍数时，从重复的字节中错开相应的位置取向量。
+// 总字节数不小于 MYSTL_SIMD_STREAM_THRESHOLD 时中间部分用流式写入
+/*****************************************************************************************/
+// 把 value 的字节重复写满 64 字节
+template <class T>
+void simd_fill_pattern(unsigned char (&pattern)[64], const T &value) {
+  for (size_t i = 0; i < 64; i += sizeof(T)) {
+    std::memcpy(pattern + i, &value, sizeof(T));
+  }
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 void simd_fill_avx2(T *first, size_t n, const T &value) {
+  unsigned char pattern[64];
+  mystl::simd_fill_pattern(pattern, value);
+  unsigned char *const p = reinterpret_cast<unsigned char *>(first);
+  const size_t bytes = n * sizeof(T);
+  const __m256i head =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pattern));
+  size_t i = 32 - reinterpret_cast<uintptr_t>(p) % 32;
+  const __m256i v = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i *>(pattern + i % sizeof(T)));
+  if (bytes >= MYSTL_SIMD_STREAM_THRESHOLD) {
+    for (; i + 32 <= bytes; i += 32) {
+      _mm256_stream_si256(reinterpret_cast<__m256i *>(p + i), v);
+    }
+    _mm_sfence();
+  } else {
+    for (; i + 32 <= bytes; i += 32) {
+      _mm256_store_si256(reinterpret_cast<__m256i *>(p + i), v);
+    }
+  }
+  // bytes - 32 是 sizeof(T) 的倍数，尾部与首部使用同样的字节排列
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), head);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(p + bytes - 32), head);
+}
+
+template <class T> void simd_fill_sse2(T *first, size_t n, const T &value) {
+  unsigned char pattern[64];
+  mystl::simd_fill_pattern(pattern, value);
+  unsigned char *const p = reinterpret_cast<unsigned char *>(first);
+  const size_t bytes = n * sizeof(T);
+  const __m128i head =
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(pattern));
+  size_t i = 16 - reinterpret_cast<uintptr_t>(p) % 16;
+  const __m128i v = _mm_loadu_si128(
+      reinterpret_cast<const __m128i *>(pattern + i % sizeof(T)));
+  if (bytes >= MYSTL_SIMD_STREAM_THRESHOLD) {
+    for (; i + 16 <= bytes; i += 16) {
+      _mm_stream_si128(reinterpret_cast<__m128i *>(p + i), v);
+    }
+    _mm_sfence();
+  } else {
+    for (; i + 16 <= bytes; i += 16) {
+      _mm_store_si128(reinterpret_cast<__m128i *>(p + i), v);
+    }
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p), head);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p + bytes - 16), head);
+}
+
+template <class T> void simd_fill(T *first, size_t n, const T &value) {
+  if (n * sizeof(T) >= 32 && mystl::simd_avx2_enabled()) {
+    mystl::simd_fill_avx2(first, n, value);
+  } else if (n * sizeof(T) >= 16) {
+    mystl::simd_fill_sse2(first, n, value);
+  } else {
+    for (; n > 0; --n, ++first) {
+      *first = value;
+    }
+  }
+}
+
+#else // !MYSTL_SIMD_X86
+
+// 没有可用的向量指令时使用标量循环
+
+template <class T>
+const T *simd_find(const T *first, const T *last, T value) {
+  if (sizeof(T) == 1 && std::is_integral<T>::value) {
+    if (first == last) {
+      return last;
+    }
+    const void *p = std::memchr(first, static_cast<unsigned char>(value),
+                                static_cast<size_t>(last - first));
+    return p == nullptr ? last : static_cast<const T *>(p);
+  }
+  for (; first != last; ++first) {
+    if (*first == value) {
+      break;
+    }
+  }
+  return first;
+}
+
+template <class T> void simd_fill(T *first, size_t n, const T &value) {
+  for (; n > 0; --n, ++first) {
+    *first = value;
+  }
+}
+
+template <class T> size_t simd_count(const T *first, const T *last, T value) {
+  size_t n = 0;
+  for (; first != last; ++first) {
+    n += *first == value ? 1 : 0;
+  }
+  return n;
+}
+
+template <class T>
+size_t simd_mismatch(const T *first1, const T *first2, size_t n) {
+  size_t i = 0;
+  while (i != n && first1[i] == first2[i]) {
+    ++i;
+  }
+  return i;
+}
+
+template <class T>
+const T *simd_search(const T *first, const T *last, const T *pattern,
+                     size_t m) {
+  if (static_cast<size_t>(last - first) < m) {
+    return last;
+  }
+  const T *end = last - (m - 1);
+  while (first < end) {
+    const void *p = std::memchr(first, static_cast<unsigned char>(pattern[0]),
+                                static_cast<size_t>(end - first));
+    if (p == nullptr) {
+      break;
+    }
+    first = static_cast<const T *>(p);
+    if (std::memcmp(first + 1, pattern + 1, m - 1) == 0) {
+      return first;
+    }
+    ++first;
+  }
+  return last;
+}
+
+inline size_t simd_intersect_u32(const uint32_t *a, size_t na,
+                                 const uint32_t *b, size_t nb, uint32_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      out[k++] = a[i];
+      ++i;
+      ++j;
+    }
+  }
+  return k;
+}
+
+#endif // MYSTL_SIMD_X86
+
+} // namespace mystl
+#endif // !MYTINYSTL_SIMD_H_
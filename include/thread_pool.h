@@ -0,0 +1,518 @@
+#ifndef MYTINYSTL_THREAD_POOL_H_
+#define MYTINYSTL_THREAD_POOL_H_
+
+// 这个头文件包含一个工作窃取(work-stealing)线程池 thread_pool，
+// 以及建立在它之上的 fork/join 辅助函数 parallel_invoke, parallel_for
+// 它是 mystl 并行算法共用的执行后端
+
+// notes:
+//
+// 每个工作线程拥有一个 Chase-Lev 双端队列，自己从底部压入/取出任务(LIFO)，
+// 其他线程从顶部窃取(FIFO)。非工作线程提交的任务放入一个共享的注入队列。
+// 等待任务完成的线程不会阻塞，而是继续执行其他任务，因此可以任意嵌套。
+// fork/join 的任务对象分配在发起者的栈上，不需要额外的内存分配。
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "algobase.h"
+#include "concurrent_queue.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl {
+
+// Chase-Lev 队列的初始容量
+#ifndef THREAD_POOL_DEQUE_INIT_SIZE
+#define THREAD_POOL_DEQUE_INIT_SIZE 256
+#endif
+
+// 工作线程找不到任务时，进入休眠前的尝试次数
+#ifndef THREAD_POOL_SPIN_COUNT
+#define THREAD_POOL_SPIN_COUNT 64
+#endif
+
+/*****************************************************************************************/
+// pool_task
+// 线程池中的任务，由 run 指向实际执行的函数
+/*****************************************************************************************/
+struct pool_task {
+  void (*run)(pool_task *);
+  std::atomic<bool> done;
+  std::exception_ptr error;
+
+  explicit pool_task(void (*f)(pool_task *)) : run(f), done(false) {}
+
+  void execute() {
+    try {
+      run(this);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    done.store(true, std::memory_order_release);
+  }
+
+  void rethrow_if_error() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+};
+
+template <class Function> struct function_task : public pool_task {
+  Function f;
+
+  explicit function_task(Function fn)
+      : pool_task(&function_task::invoke), f(fn) {}
+
+  static void invoke(pool_task *t) { static_cast<function_task *>(t)->f(); }
+};
+
+/*****************************************************************************************/
+// work_stealing_deque
+// Chase-Lev 双端队列，只有拥有者调用 push/take，其他线程调用 steal
+/*****************************************************************************************/
+template <class T> class work_stealing_deque {
+private:
+  struct ring_array {
+    ptrdiff_t capacity;
+    std::atomic<T *> *buffer;
+    ring_array *prev; // 扩容前的数组，在析构时释放
+
+    explicit ring_array(ptrdiff_t n)
+        : capacity(n), buffer(new std::atomic<T *>[n]), prev(nullptr) {}
+    ~ring_array() { delete[] buffer; }
+
+    T *get(ptrdiff_t i) const {
+      return buffer[i & (capacity - 1)].load(std::memory_order_acquire);
+    }
+    void put(ptrdiff_t i, T *x) {
+      buffer[i & (capacity - 1)].store(x, std::memory_order_release);
+    }
+  };
+
+  alignas(64) std::atomic<ptrdiff_t> top_;
+  alignas(64) std::atomic<ptrdiff_t> bottom_;
+  std::atomic<ring_array *> array_;
+
+public:
+  work_stealing_deque() : top_(0), bottom_(0) {
+    array_.store(new ring_array(THREAD_POOL_DEQUE_INIT_SIZE),
+                 std::memory_order_relaxed);
+  }
+
+  ~work_stealing_deque() {
+    ring_array *a = array_.load(std::memory_order_relaxed);
+    while (a != nullptr) {
+      ring_array *prev = a->prev;
+      delete a;
+      a = prev;
+    }
+  }
+
+  work_stealing_deque(const work_stealing_deque &) = delete;
+  work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+  bool empty() const noexcept {
+    return bottom_.load(std::memory_order_relaxed) <=
+           top_.load(std::memory_order_relaxed);
+  }
+
+  // 拥有者从底部压入
+  void push(T *x) {
+    const ptrdiff_t b = bottom_.load(std::memory_order_relaxed);
+    const ptrdiff_t t = top_.load(std::memory_order_acquire);
+    ring_array *a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+      a = grow(a, b, t);
+    }
+    a->put(b, x);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // 拥有者从底部取出，队列为空时返回 nullptr
+  T *take() {
+    const ptrdiff_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    ring_array *a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ptrdiff_t t = top_.load(std::memory_order_relaxed);
+    T *x = nullptr;
+    if (t <= b) {
+      x = a->get(b);
+      if (t == b) {
+        // 只剩最后一个元素，与窃取者竞争
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+          x = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return x;
+  }
+
+  // 其他线程从顶部窃取，队列为空或竞争失败时返回 nullptr
+  T *steal() {
+    ptrdiff_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const ptrdiff_t b = bottom_.load(std::memory_order_acquire);
+    if (t < b) {
+      ring_array *a = array_.load(std::memory_order_acquire);
+      T *x = a->get(t);
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        return nullptr;
+      }
+      return x;
+    }
+    return nullptr;
+  }
+
+private:
+  ring_array *grow(ring_array *a, ptrdiff_t b, ptrdiff_t t) {
+    ring_array *na = new ring_array(a->capacity * 2);
+    for (ptrdiff_t i = t; i < b; ++i) {
+      na->put(i, a->get(i));
+    }
+    na->prev = a;
+    array_.store(na, std::memory_order_release);
+    return na;
+  }
+};
+
+/*****************************************************************************************/
+// thread_pool
+/*****************************************************************************************/
+class thread_pool {
+private:
+  struct worker {
+    work_stealing_deque<pool_task> deque;
+    std::thread thread;
+  };
+
+  // 当前线程所属的线程池及其编号
+  struct worker_info {
+    thread_pool *pool;
+    size_t index;
+    size_t seed; // 随机选择窃取对象
+  };
+
+  static worker_info &current() {
+    static thread_local worker_info info = {nullptr, 0, 0};
+    return info;
+  }
+
+  size_t size_;
+  worker *workers_;
+  concurrent_queue<pool_task *> injected_; // 非工作线程提交的任务
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::atomic<size_t> sleeping_;
+  std::atomic<bool> stop_;
+
+public:
+  // n 为工作线程数，为 0 时所有任务由等待者自己执行
+  explicit thread_pool(size_t n = default_concurrency())
+      : size_(n), workers_(nullptr), sleeping_(0), stop_(false) {
+    workers_ = new worker[size_ == 0 ? 1 : size_];
+    for (size_t i = 0; i < size_; ++i) {
+      try {
+        workers_[i].thread = std::thread(&thread_pool::worker_loop, this, i);
+      } catch (...) {
+        size_ = i;
+        shutdown();
+        throw;
+      }
+    }
+  }
+
+  ~thread_pool() { shutdown(); }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+
+  static size_t default_concurrency() {
+    const size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+  size_t size() const noexcept { return size_; }
+
+  // 当前线程是否为本线程池的工作线程
+  bool in_worker() const noexcept { return current().pool == this; }
+
+  // 提交任务，任务完成前 t 必须保持有效
+  void spawn(pool_task *t);
+
+  // 等待任务完成，等待期间执行其他任务
+  void wait(pool_task *t);
+
+  // fork/join 辅助函数
+  template <class F1, class F2> void parallel_invoke(F1 &&f1, F2 &&f2);
+  template <class F1, class F2, class F3, class... Fs>
+  void parallel_invoke(F1 &&f1, F2 &&f2, F3 &&f3, Fs &&...fs);
+
+  template <class Index, class Function>
+  void parallel_for(Index first, Index last, size_t grain, Function f);
+  template <class Index, class Function>
+  void parallel_for(Index first, Index last, Function f);
+
+  // 按工作线程数给出一个默认的划分粒度
+  size_t default_grain(size_t n) const noexcept {
+    const size_t chunks = (size_ + 1) * 8;
+    return n / chunks == 0 ? 1 : n / chunks;
+  }
+
+private:
+  // helper functions
+  void worker_loop(size_t index);
+  pool_task *find_task(size_t self);
+  bool has_task() const;
+  void notify();
+  void shutdown();
+
+  template <class Index, class Function>
+  void parallel_for_aux(Index first, Index last, size_t grain, Function &f);
+};
+
+/*****************************************************************************************/
+
+inline void thread_pool::spawn(pool_task *t) {
+  worker_info &info = current();
+  if (info.pool == this) {
+    workers_[info.index].deque.push(t);
+  } else {
+    injected_.push(t);
+  }
+  notify();
+}
+
+inline void thread_pool::wait(pool_task *t) {
+  const size_t self = in_worker() ? current().index : size_;
+  while (!t->done.load(std::memory_order_acquire)) {
+    pool_task *other = find_task(self);
+    if (other != nullptr) {
+      other->execute();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// 并行执行 f1 与 f2，f2 交给线程池，f1 在当前线程执行
+template <class F1, class F2>
+void thread_pool::parallel_invoke(F1 &&f1, F2 &&f2) {
+  auto g = [&f2]() { f2(); };
+  function_task<decltype(g)> t(g);
+  spawn(&t);
+  try {
+    f1();
+  } catch (...) {
+    wait(&t);
+    throw;
+  }
+  wait(&t);
+  t.rethrow_if_error();
+}
+
+template <class F1, class F2, class F3, class... Fs>
+void thread_pool::parallel_invoke(F1 &&f1, F2 &&f2, F3 &&f3, Fs &&...fs) {
+  parallel_invoke(mystl::forward<F1>(f1), [&]() {
+    parallel_invoke(mystl::forward<F2>(f2), mystl::forward<F3>(f3),
+                    mystl::forward<Fs>(fs)...);
+  });
+}
+
+// 对区间 [first, last) 做二分递归划分，长度不超过 grain 的子区间调用
+// f(sub_first, sub_last)，Index 可以是整数或随机访问迭代器
+template <class Index, class Function>
+void thread_pool::parallel_for(Index first, Index last, size_t grain,
+                               Function f) {
+  if (!(first < last)) {
+    return;
+  }
+  parallel_for_aux(first, last, grain == 0 ? 1 : grain, f);
+}
+
+template <class Index, class Function>
+void thread_pool::parallel_for(Index first, Index last, Function f) {
+  if (!(first < last)) {
+    return;
+  }
+  parallel_for_aux(first, last,
+                   default_grain(static_cast<size_t>(last - first)), f);
+}
+
+template <class Index, class Function>
+void thread_pool::parallel_for_aux(Index first, Index last, size_t grain,
+                                   Function &f) {
+  if (static_cast<size_t>(last - first) <= grain) {
+    f(first, last);
+    return;
+  }
+  Index mid = first + (last - first) / 2;
+  parallel_invoke([&]() { parallel_for_aux(first, mid, grain, f); },
+                  [&]() { parallel_for_aux(mid, last, grain, f); });
+}
+
+/*****************************************************************************************/
+// helper function
+
+inline void thread_pool::worker_loop(size_t index) {
+  worker_info &info = current();
+  info.pool = this;
+  info.index = index;
+  info.seed = index * 0x9e3779b97f4a7c15ULL + 1;
+  size_t idle = 0;
+  while (!stop_.load(std::memory_order_acquire)) {
+    pool_task *t = find_task(index);
+    if (t != nullptr) {
+      t->execute();
+      idle = 0;
+      continue;
+    }
+    if (++idle < THREAD_POOL_SPIN_COUNT) {
+      std::this_thread::yield();
+      continue;
+    }
+    // 进入休眠，休眠前再次检查，避免错过 notify
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_.fetch_add(1);
+    if (!has_task() && !stop_.load()) {
+      cond_.wait(lock);
+    }
+    sleeping_.fetch_sub(1);
+    idle = 0;
+  }
+}
+
+// 依次尝试：自己的队列，注入队列，随机窃取其他工作线程
+inline pool_task *thread_pool::find_task(size_t self) {
+  pool_task *t = nullptr;
+  if (self < size_) {
+    t = workers_[self].deque.take();
+    if (t != nullptr) {
+      return t;
+    }
+  }
+  if (injected_.try_pop(t)) {
+    return t;
+  }
+  if (size_ == 0) {
+    return nullptr;
+  }
+  worker_info &info = current();
+  // xorshift 产生窃取起点
+  size_t x = info.seed == 0 ? 0x2545f4914f6cdd1dULL : info.seed;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  info.seed = x;
+  const size_t start = x % size_;
+  for (size_t i = 0; i < size_; ++i) {
+    const size_t victim = (start + i) % size_;
+    if (victim == self) {
+      continue;
+    }
+    t = workers_[victim].deque.steal();
+    if (t != nullptr) {
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+inline bool thread_pool::has_task() const {
+  if (!injected_.empty()) {
+    return true;
+  }
+  for (size_t i = 0; i < size_; ++i) {
+    if (!workers_[i].deque.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 任务入队后唤醒一个休眠的工作线程
+inline void thread_pool::notify() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load() != 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cond_.notify_one();
+  }
+}
+
+inline void thread_pool::shutdown() {
+  if (workers_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_.store(true);
+    cond_.notify_all();
+  }
+  for (size_t i = 0; i < size_; ++i) {
+    if (workers_[i].thread.joinable()) {
+      workers_[i].thread.join();
+    }
+  }
+  delete[] workers_;
+  workers_ = nullptr;
+}
+
+/*****************************************************************************************/
+// default_thread_pool
+// mystl 并行算法默认使用的线程池，在第一次使用时创建
+// set_default_thread_pool_size 需要在第一次使用之前调用才会生效
+/*****************************************************************************************/
+inline std::atomic<size_t> &default_thread_pool_size() {
+  static std::atomic<size_t> n(thread_pool::default_concurrency());
+  return n;
+}
+
+inline void set_default_thread_pool_size(size_t n) {
+  default_thread_pool_size().store(n);
+}
+
+inline thread_pool &default_thread_pool() {
+  static thread_pool pool(default_thread_pool_size().load());
+  return pool;
+}
+
+/*****************************************************************************************/
+// parallel_invoke
+// 在默认线程池上并行执行若干个函数对象，全部完成后返回
+/*****************************************************************************************/
+template <class F1, class F2, class... Fs>
+void parallel_invoke(F1 &&f1, F2 &&f2, Fs &&...fs) {
+  mystl::default_thread_pool().parallel_invoke(mystl::forward<F1>(f1),
+                                               mystl::forward<F2>(f2),
+                                               mystl::forward<Fs>(fs)...);
+}
+
+/*****************************************************************************************/
+// parallel_for
+// 在默认线程池上把 [first, last) 划分为长度不超过 grain 的子区间，
+// 对每个子区间调用 f(sub_first, sub_last)
+/*****************************************************************************************/
+template <class Index, class Function>
+void parallel_for(Index first, Index last, size_t grain, Function f) {
+  mystl::default_thread_pool().parallel_for(first, last, grain, f);
+}
+
+template <class Index, class Function>
+void parallel_for(Index first, Index last, Function f) {
+  mystl::default_thread_pool().parallel_for(first, last, f);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_THREAD_POOL_H_
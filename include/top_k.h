@@ -0,0 +1,109 @@
+#ifndef MYTINYSTL_TOP_K_H_
+#define MYTINYSTL_TOP_K_H_
+
+// 这个头文件包含一个模板类 top_k
+// top_k : 从任意长度的输入流中保留按 comp 排序最靠前的 k 个元素
+
+// notes:
+//
+// 内部以 comp 为序维护一个大小不超过 k 的最大堆，堆顶是当前保留的元素中
+// 最靠后的一个。新元素只需与堆顶比较一次，不能进入前 k 个时直接丢弃，
+// 因此只使用 O(k) 的空间，处理 n 个元素的时间为 O(n + m log k)，
+// m 为替换堆顶的次数。默认的 mystl::less<T> 保留最小的 k 个元素，
+// 使用 mystl::greater<T> 时保留最大的 k 个元素
+
+#include <cstddef>
+
+#include "exceptdef.h"
+#include "functional.h"
+#include "heap_algo.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+template <class T, class Compared = mystl::less<T>> class top_k {
+public:
+  typedef T value_type;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef Compared value_compare;
+  typedef const T &const_reference;
+
+private:
+  mystl::vector<T> heap_; // 以 comp_ 为序的最大堆
+  size_type k_;           // 最多保留的元素个数
+  Compared comp_;
+
+public:
+  explicit top_k(size_type k, const Compared &comp = Compared())
+      : k_(k), comp_(comp) {
+    heap_.reserve(k);
+  }
+
+  // 容量相关操作
+  bool empty() const noexcept { return heap_.empty(); }
+  bool full() const noexcept { return heap_.size() == k_; }
+  size_type size() const noexcept { return heap_.size(); }
+  size_type limit() const noexcept { return k_; }
+  value_compare value_comp() const { return comp_; }
+
+  // 当前保留的元素中最靠后的一个，之后的元素必须排在它之前才能被保留
+  const_reference top() const {
+    MYSTL_DEBUG(!empty());
+    return heap_.front();
+  }
+
+  void push(const value_type &value) {
+    if (heap_.size() < k_) {
+      heap_.emplace_back(value);
+      mystl::push_heap(heap_.begin(), heap_.end(), comp_);
+    } else if (k_ != 0 && comp_(value, heap_.front())) {
+      replace_top(value_type(value));
+    }
+  }
+
+  void push(value_type &&value) {
+    if (heap_.size() < k_) {
+      heap_.emplace_back(mystl::move(value));
+      mystl::push_heap(heap_.begin(), heap_.end(), comp_);
+    } else if (k_ != 0 && comp_(value, heap_.front())) {
+      replace_top(mystl::move(value));
+    }
+  }
+
+  template <class InputIter> void push(InputIter first, InputIter last) {
+    for (; first != last && heap_.size() < k_; ++first) {
+      heap_.emplace_back(*first);
+      mystl::push_heap(heap_.begin(), heap_.end(), comp_);
+    }
+    if (k_ == 0) {
+      return;
+    }
+    for (; first != last; ++first) {
+      if (comp_(*first, heap_.front())) {
+        replace_top(value_type(*first));
+      }
+    }
+  }
+
+  // 按 comp 的顺序返回当前保留的元素
+  mystl::vector<T> sorted() const {
+    mystl::vector<T> result(heap_.begin(), heap_.end());
+    mystl::sort_heap(result.begin(), result.end(), comp_);
+    return result;
+  }
+
+  void clear() { heap_.clear(); }
+
+private:
+  // 用 value 替换堆顶后下滤
+  void replace_top(value_type &&value) {
+    mystl::adjust_heap(heap_.begin(), static_cast<difference_type>(0),
+                       static_cast<difference_type>(heap_.size()),
+                       mystl::move(value), comp_);
+  }
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_TOP_K_H_
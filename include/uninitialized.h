@@ -49,14 +49,39 @@ ForwardIter unchecked_uninit_copy(InputIter first, InputIter last,
 }
 
 template <class InputIter, class ForwardIter>
-ForwardIter uninitialized_copy(InputIter first, InputIter last,
-                               ForwardIter result) {
+ForwardIter uninit_copy_dispatch(InputIter first, InputIter last,
+                                 ForwardIter result, m_false_type) {
   return mystl::unchecked_uninit_copy(
       first, last, result,
       std::is_trivially_copy_assignable<
           typename iterator_traits<ForwardIter>::value_type>{});
 }
 
+// 来源为分段迭代器时逐段构造。某段抛出异常时，该段已构造的元素由该段自行析构，
+// 这里再析构之前各段构造的元素
+template <class SegIter, class ForwardIter>
+ForwardIter uninit_copy_dispatch(SegIter first, SegIter last,
+                                 ForwardIter result, m_true_type) {
+  auto cur = result;
+  try {
+    mystl::for_each_segment(first, last, [&cur](auto, auto f, auto l) {
+      cur = mystl::uninit_copy_dispatch(f, l, cur, m_false_type());
+      return false;
+    });
+  } catch (...) {
+    mystl::destroy(result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class InputIter, class ForwardIter>
+ForwardIter uninitialized_copy(InputIter first, InputIter last,
+                               ForwardIter result) {
+  return mystl::uninit_copy_dispatch(first, last, result,
+                                     is_segmented_iterator<InputIter>());
+}
+
 /***************************************************************** */
 // uninitialized_copy_n
 // 把[first, first+n)上的内容复制到以result为起始处的空间，返回复制结束的位置
@@ -85,7 +110,7 @@ ForwardIter unchecked_uninit_copy_n(InputIter first, Size n, ForwardIter result,
 }
 
 template <class InputIter, class Size, class ForwardIter>
-ForwardIter uninitialized_fill_n(InputIter first, Size n, ForwardIter result) {
+ForwardIter uninitialized_copy_n(InputIter first, Size n, ForwardIter result) {
   return mystl::unchecked_uninit_copy_n(
       first, n, result,
       std::is_trivially_copy_assignable<
@@ -119,13 +144,37 @@ void unchecked_uninit_fill(ForwardIter first, ForwardIter last, const T &value,
 }
 
 template <class ForwardIter, class T>
-void uninitialized_fill(ForwardIter first, ForwardIter last, const T &value) {
+void uninit_fill_dispatch(ForwardIter first, ForwardIter last, const T &value,
+                          m_false_type) {
   mystl::unchecked_uninit_fill(
       first, last, value,
       std::is_trivially_copy_assignable<
           typename iterator_traits<ForwardIter>::value_type>{});
 }
 
+// 目标为分段迭代器时逐段构造，异常时析构之前各段构造的元素
+template <class SegIter, class T>
+void uninit_fill_dispatch(SegIter first, SegIter last, const T &value,
+                          m_true_type) {
+  auto cur = first;
+  try {
+    mystl::for_each_segment(first, last, [&](auto, auto f, auto l) {
+      mystl::uninit_fill_dispatch(f, l, value, m_false_type());
+      cur += l - f;
+      return false;
+    });
+  } catch (...) {
+    mystl::destroy(first, cur);
+    throw;
+  }
+}
+
+template <class ForwardIter, class T>
+void uninitialized_fill(ForwardIter first, ForwardIter last, const T &value) {
+  mystl::uninit_fill_dispatch(first, last, value,
+                              is_segmented_iterator<ForwardIter>());
+}
+
 /*****************************************************************************************/
 // uninitialized_fill_n
 // 从 first 位置开始，填充 n 个元素值，返回填充结束的位置
@@ -155,13 +204,31 @@ ForwardIter unchecked_uninit_fill_n(ForwardIter first, Size n, const T &value,
 }
 
 template <class ForwardIter, class Size, class T>
-ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T &value) {
+ForwardIter uninit_fill_n_dispatch(ForwardIter first, Size n, const T &value,
+                                   m_false_type) {
   return mystl::unchecked_uninit_fill_n(
       first, n, value,
       std::is_trivially_copy_assignable<
           typename iterator_traits<ForwardIter>::value_type>{});
 }
 
+template <class SegIter, class Size, class T>
+SegIter uninit_fill_n_dispatch(SegIter first, Size n, const T &value,
+                               m_true_type) {
+  if (n <= 0) {
+    return first;
+  }
+  const SegIter last = first + n;
+  mystl::uninitialized_fill(first, last, value);
+  return last;
+}
+
+template <class ForwardIter, class Size, class T>
+ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T &value) {
+  return mystl::uninit_fill_n_dispatch(first, n, value,
+                                       is_segmented_iterator<ForwardIter>());
+}
+
 /*****************************************************************************************/
 // uninitialized_move
 // 把[first, last)上的内容移动到以 result 为起始处的空间，返回移动结束的位置
@@ -190,13 +257,37 @@ ForwardIter unchecked_uninit_move(InputIter first, InputIter last,
 }
 
 template <class InputIter, class ForwardIter>
-ForwardIter uninitialized_move(InputIter first, InputIter last,
-                               ForwardIter result) {
+ForwardIter uninit_move_dispatch(InputIter first, InputIter last,
+                                 ForwardIter result, m_false_type) {
   return mystl::unchecked_uninit_move(
       first, last, result,
       std::is_trivially_move_assignable<
           typename iterator_traits<ForwardIter>::value_type>{});
 }
+
+// 来源为分段迭代器时逐段移动构造，异常时析构之前各段构造的元素
+template <class SegIter, class ForwardIter>
+ForwardIter uninit_move_dispatch(SegIter first, SegIter last,
+                                 ForwardIter result, m_true_type) {
+  auto cur = result;
+  try {
+    mystl::for_each_segment(first, last, [&cur](auto, auto f, auto l) {
+      cur = mystl::uninit_move_dispatch(f, l, cur, m_false_type());
+      return false;
+    });
+  } catch (...) {
+    mystl::destroy(result, cur);
+    throw;
+  }
+  return cur;
+}
+
+template <class InputIter, class ForwardIter>
+ForwardIter uninitialized_move(InputIter first, InputIter last,
+                               ForwardIter result) {
+  return mystl::uninit_move_dispatch(first, last, result,
+                                     is_segmented_iterator<InputIter>());
+}
 /*****************************************************************************************/
 // uninitialized_move_n
 // 把[first, first + n)上的内容移动到以 result
@@ -17,7 +17,6 @@
 #include <initializer_list>
 #include <iterator>
 
-#include "algo.h"
 #include "algobase.h"
 #include "exceptdef.h"
 #include "iterator.h"
@@ -224,6 +223,16 @@ public:
 
   template <class... Args> void emplace_back(Args &&...args);
 
+  // push_back / pop_back
+  void push_back(const value_type &value);
+  void push_back(value_type &&value) { emplace_back(mystl::move(value)); }
+
+  void pop_back() {
+    MYSTL_DEBUG(!empty());
+    data_allocator::destroy(end_ - 1);
+    --end_;
+  }
+
   // insert
   iterator insert(const_iterator pos, const value_type &value);
   iterator insert(const_iterator pos, value_type &&value) {
@@ -385,6 +394,16 @@ void vector<T>::emplace_back(Args &&...args) {
   }
 }
 
+// 在尾部插入元素
+template <class T> void vector<T>::push_back(const value_type &value) {
+  if (end_ != cap_) {
+    data_allocator::construct(mystl::address_of(*end_), value);
+    ++end_;
+  } else {
+    reallocate_insert(end_, value);
+  }
+}
+
 // 删除pos位置上的元素
 template <class T>
 typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
@@ -559,7 +578,7 @@ void vector<T>::reallocate_emplace(iterator pos, Args &&...args) {
   auto new_begin = data_allocator::allocate(new_size);
   auto new_end = new_begin;
   try {
-    new_end = mystl::uninitialized_copy(begin_, pos, new_begin);
+    new_end = mystl::uninitialized_move(begin_, pos, new_begin);
     data_allocator::construct(mystl::address_of(*new_end),
                               mystl::forward<Args>(args)...);
     ++new_end;
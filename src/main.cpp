@@ -1,13 +1,31 @@
+#include "../include/aho_corasick.h"
+#include "../include/alias_table.h"
 #include "../include/algo.h"
 #include "../include/algobase.h"
 #include "../include/allocator.h"
+#include "../include/concurrent_queue.h"
 #include "../include/construct.h"
 #include "../include/deque.h"
+#include "../include/execution.h"
+#include "../include/external_sort.h"
+#include "../include/eytzinger.h"
 #include "../include/functional.h"
 #include "../include/heap_algo.h"
+#include "../include/indexed_heap.h"
 #include "../include/iterator.h"
 #include "../include/list.h"
+#include "../include/multiway_merge.h"
+#include "../include/numeric.h"
+#include "../include/pairing_heap.h"
+#include "../include/parallel_algo.h"
+#include "../include/queue.h"
+#include "../include/random.h"
 #include "../include/rb_tree.h"
+#include "../include/searcher.h"
+#include "../include/set_algo.h"
+#include "../include/simd.h"
+#include "../include/thread_pool.h"
+#include "../include/top_k.h"
 #include "../include/type_traits.h"
 #include "../include/uninitialized.h"
 #include "../include/util.h"
@@ -22,6 +40,26 @@ int main(int argc, char **argv) {
   std::cout << "pair1.second: " << pair1.second << std::endl;
   mystl::pair<int, double> pair2(pair1);
   std::cout << "hello world!" << std::endl;
+
+  // 元素与值的符号不同时，向量化的 find/count 应与逐个用 == 比较的结果相同，
+  // deque 逐段调用指针版本，结果也应相同
+  short shorts[64];
+  signed char chars[64];
+  mystl::fill_n(shorts, 64, static_cast<short>(-1));
+  mystl::fill_n(chars, 64, static_cast<signed char>(-1));
+  mystl::deque<short> dq(1000, static_cast<short>(-1));
+  const unsigned short us = 65535;
+  const unsigned char uc = 255;
+  if (mystl::find(shorts, shorts + 64, us) != shorts + 64 ||
+      mystl::count(shorts, shorts + 64, us) != 0 ||
+      mystl::find(chars, chars + 64, uc) != chars + 64 ||
+      mystl::count(chars, chars + 64, uc) != 0 ||
+      mystl::find(dq.begin(), dq.end(), us) != dq.end() ||
+      mystl::count(dq.begin(), dq.end(), us) != 0 ||
+      mystl::count(shorts, shorts + 64, -1) != 64) {
+    std::cout << "mixed-sign find/count mismatch" << std::endl;
+    return 1;
+  }
   // mystl::rotate_dispatch(ForwardIter first, ForwardIter middle, ForwardIter
   // last, mystl::forward_iterator_tag)
   return 0;
@@ -8,6 +8,7 @@ target("MyTinySTL")
     add_headerfiles("include/*.h")
     set_languages("c++23")
     add_packages("mimalloc")
+    add_syslinks("pthread")
 
 --
 -- If you want to known more usage about xmake, please see https://xmake.io